@@ -0,0 +1,211 @@
+/**
+ * Bench.h - On-device benchmark of the status -> screen hot path
+ *
+ * Built only in the esp32dev-bench environment (BREW_BENCH=1). Sending 'b'
+ * on the USB serial console replays a synthetic shot recording (preheat,
+ * brew ramp, flow, done; ShotCapture.h) through the real code:
+ *
+ *   bytes -> UartLineRing framing -> BrewJson / PicoProto decode
+ *         -> BrewScreen::update() -> BrewScreen::draw()
+ *
+ * once as JSON lines and once as binary frames. For each pass it reports
+ * throughput per stage, heap allocations per frame, and GfxDriver calls
+ * and pixels touched per frame. test/test_bench replays the same capture
+ * on the host (env:native).
+ *
+ * The screen under test is a second BrewScreen drawing into CountingGfx,
+ * a TFT_eSPI_Driver over an unallocated sprite: every draw call is counted
+ * and then discarded, so the panel and the live screen are untouched. It
+ * draws directly, without the compositor or glyph atlases, so text goes
+ * through the GfxDriver one cell at a time and the counts are an upper
+ * bound on what the panel does.
+ *
+ * Allocations are counted by wrapping malloc/calloc/realloc at link time
+ * (-Wl,--wrap, see platformio.ini); include this header from main.cpp only.
+ * The live UI pauses while the benchmark runs; the protocol task on core
+ * 0 does not.
+ */
+
+#pragma once
+
+#if BREW_BENCH
+
+#include <Arduino.h>
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+#include <atomic>
+#include <drivers/TFT_eSPI_Driver.h>
+
+#include "BrewScreen.h"
+#include "BrewStatus.h"
+#include "BrewJson.h"
+#include "PicoProtocol.h"
+#include "ShotCapture.h"
+#include "UartRx.h"
+
+// ---- Heap allocation counter (link-time wrappers) ----
+
+namespace Bench {
+inline std::atomic<uint32_t> heapAllocs{0};
+}
+
+extern "C" {
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n) {
+    Bench::heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_malloc(n);
+}
+void *__wrap_calloc(size_t n, size_t size) {
+    Bench::heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_calloc(n, size);
+}
+void *__wrap_realloc(void *p, size_t n) {
+    Bench::heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_realloc(p, n);
+}
+}
+
+namespace Bench {
+
+static constexpr uint16_t FRAMES = 1000;
+
+// ---- Draw-call counter ----
+
+// Sprite first, so it exists before the driver that wraps it
+struct NullCanvas {
+    TFT_eSprite sink;
+    explicit NullCanvas(TFT_eSPI &tft) : sink(&tft) {}  // Never created: draws are no-ops
+};
+
+class CountingGfx : private NullCanvas, public TFT_eSPI_Driver {
+public:
+    uint32_t calls = 0;
+    uint32_t pixels = 0;
+
+private:
+    uint8_t textSize = 1;
+
+public:
+    explicit CountingGfx(TFT_eSPI &tft) : NullCanvas(tft), TFT_eSPI_Driver(sink) {}
+
+    void reset() { calls = 0; pixels = 0; }
+
+    void fillScreen(uint16_t c) override {
+        calls++; pixels += 240 * 320;
+        TFT_eSPI_Driver::fillScreen(c);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) override {
+        calls++; pixels += (uint32_t)w * h;
+        TFT_eSPI_Driver::fillRect(x, y, w, h, c);
+    }
+    void setTextSize(uint8_t s) override {
+        textSize = s;
+        TFT_eSPI_Driver::setTextSize(s);
+    }
+    void drawString(const char *s, int16_t x, int16_t y) override {
+        // GLCD cells, background included
+        calls++; pixels += (uint32_t)strlen(s) * 6 * textSize * 8 * textSize;
+        TFT_eSPI_Driver::drawString(s, x, y);
+    }
+    void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t c) override {
+        calls++; pixels += 6 * r;  // ~circumference
+        TFT_eSPI_Driver::drawCircle(x, y, r, c);
+    }
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) override {
+        calls++; pixels += abs(x1 - x0) > abs(y1 - y0) ? abs(x1 - x0) + 1 : abs(y1 - y0) + 1;
+        TFT_eSPI_Driver::drawLine(x0, y0, x1, y1, c);
+    }
+};
+
+// ---- Runner ----
+
+struct Result {
+    uint32_t parseCycles = 0, updateCycles = 0, drawCycles = 0;
+    uint32_t frames = 0, allocs = 0, calls = 0, pixels = 0;
+};
+
+inline Result replay(bool binary, BrewScreen &screen, BrewStatus &status, CountingGfx &gfx) {
+    static UartLineRing<4, BrewJson::MAX_FRAME_LEN> ring;  // Too big for the stack
+    Result r;
+    char wire[BrewJson::MAX_FRAME_LEN];
+
+    screen.onEnter();
+    screen.update();
+    screen.draw();  // First full draw is not part of the steady state
+    gfx.reset();
+
+    uint32_t allocs0 = heapAllocs.load();
+    for (uint16_t i = 0; i < FRAMES; i++) {
+        PicoProto::StatusPayload s;
+        ShotCapture::frame(i, s);
+        size_t n = binary ? ShotCapture::encodeBinary(s, (uint8_t *)wire)
+                          : ShotCapture::encodeJson(s, wire, sizeof(wire));
+
+        uint32_t t0 = ESP.getCycleCount();
+        ring.feed((const uint8_t *)wire, n);
+        RxSpan span;
+        while (ring.peek(span)) {
+            bool ok = span.binary
+                ? PicoProto::decode((const uint8_t *)span.data, span.len, status)
+                : BrewJson::parse(span.data, span.len, status) > 0;
+            if (ok) r.frames++;
+            ring.release();
+        }
+        uint32_t t1 = ESP.getCycleCount();
+        screen.update();
+        uint32_t t2 = ESP.getCycleCount();
+        screen.draw();
+        uint32_t t3 = ESP.getCycleCount();
+
+        r.parseCycles += t1 - t0;
+        r.updateCycles += t2 - t1;
+        r.drawCycles += t3 - t2;
+    }
+    r.allocs = heapAllocs.load() - allocs0;
+    r.calls = gfx.calls;
+    r.pixels = gfx.pixels;
+    return r;
+}
+
+inline void report(Print &out, const char *name, const Result &r) {
+    const uint32_t mhz = getCpuFrequencyMhz();
+    auto perSec = [&](uint32_t cycles) -> unsigned {
+        return cycles ? (unsigned)((uint64_t)r.frames * mhz * 1000000 / cycles) : 0;
+    };
+    auto usPer = [&](uint32_t cycles) -> double {
+        return r.frames ? (double)cycles / mhz / r.frames : 0;
+    };
+    out.printf("[BENCH] %s: %u frames\n", name, (unsigned)r.frames);
+    out.printf("  parse   %7u frames/s  %7.2f us/frame\n", perSec(r.parseCycles), usPer(r.parseCycles));
+    out.printf("  update  %7u frames/s  %7.2f us/frame\n", perSec(r.updateCycles), usPer(r.updateCycles));
+    out.printf("  draw    %7u frames/s  %7.2f us/frame\n", perSec(r.drawCycles), usPer(r.drawCycles));
+    if (r.frames) {
+        out.printf("  allocs %.2f  draw calls %.1f  pixels %u  (per frame)\n",
+                   (double)r.allocs / r.frames, (double)r.calls / r.frames,
+                   (unsigned)(r.pixels / r.frames));
+    }
+}
+
+inline void run(Print &out, TFT_eSPI &tft, const ForgeTheme &theme) {
+    out.println("[BENCH] Replaying synthetic shot capture...");
+
+    // Built once and kept: ForgeUI screens own their widgets for life
+    static CountingGfx *gfx = nullptr;
+    static BrewStatus status;
+    static BrewScreen *screen = nullptr;
+    if (!screen) {
+        gfx = new CountingGfx(tft);
+        screen = new BrewScreen(*gfx, theme, status);
+        screen->setup();
+    }
+
+    report(out, "json", replay(false, *screen, status, *gfx));
+    report(out, "binary", replay(true, *screen, status, *gfx));
+}
+
+}  // namespace Bench
+
+#endif  // BREW_BENCH
@@ -0,0 +1,29 @@
+/**
+ * BootTrace.h - Boot phase timestamps on the serial log
+ *
+ *   BootTrace::mark("panel init");
+ *   // [Boot]   412.3 ms  (+301.8)  panel init
+ *
+ * Times are from esp_timer, i.e. since the chip came out of reset, so the
+ * first mark already includes the bootloader. The "first frame on panel"
+ * mark is the number to watch: time from power-up to a live status screen.
+ * Safe to call from either core.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+
+namespace BootTrace {
+
+inline std::atomic<uint32_t> lastUs{0};
+
+inline void mark(const char *phase) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t prev = lastUs.exchange(now);
+    Serial.printf("[Boot] %8.1f ms  (+%.1f)  %s\n", now / 1000.0, (now - prev) / 1000.0, phase);
+}
+
+}  // namespace BootTrace
@@ -0,0 +1,256 @@
+/**
+ * BrewJson.h - Zero-allocation parser for Pico status frames
+ *
+ * The Pico sends one flat JSON object per line:
+ *   {"temp":92.4,"tempF":198.3,"target":93,"state":"BREW","step":3,...}
+ *
+ * parse() walks the line once. Each "key":value pair is tokenized in place,
+ * the key is looked up in a constexpr table and the value is written straight
+ * into the matching BrewStatus field, setting its dirty bit if it changed.
+ * Decimals are read straight into BrewStatus's scaled integers (92.4 ->
+ * 924 tenths). No String temporaries, no heap, no floats.
+ *
+ * Deliberately minimal: flat objects only, no escapes inside strings,
+ * numbers as plain decimals. Unknown keys are skipped; keys missing from a
+ * frame leave the previous value in place.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "BrewStatus.h"
+
+namespace BrewJson {
+
+// Longest line the UART layer will hand us (excluding the terminator)
+static constexpr size_t MAX_FRAME_LEN = 1024;
+
+// Deci/Centi: int16 in tenths/hundredths of the JSON value
+enum class FieldType : uint8_t { Deci, Centi, Int, Bool, Str };
+
+struct FieldDef {
+    const char *key;
+    uint8_t     keyLen;
+    FieldType   type;
+    uint16_t    offset;
+    uint8_t     size;
+    uint16_t    bit;  // BrewField
+};
+
+#define BREW_JSON_FIELD(key, member, type, bit) \
+    { key, sizeof(key) - 1, FieldType::type, \
+      offsetof(BrewStatus, member), sizeof(BrewStatus::member), bit }
+
+static constexpr FieldDef FIELDS[] = {
+    BREW_JSON_FIELD("temp",        temp,        Deci,  BF_TEMP),
+    BREW_JSON_FIELD("tempF",       tempF,       Deci,  BF_TEMPF),
+    BREW_JSON_FIELD("target",      target,      Deci,  BF_TARGET),
+    BREW_JSON_FIELD("flow",        flow,        Deci,  BF_FLOW),
+    BREW_JSON_FIELD("volume",      volume,      Deci,  BF_VOLUME),
+    BREW_JSON_FIELD("tempRate",    tempRate,    Centi, BF_TEMPRATE),
+    BREW_JSON_FIELD("step",        step,        Int,   BF_STEP),
+    BREW_JSON_FIELD("stepElapsed", stepElapsed, Int,   BF_STEP_ELAPSED),
+    BREW_JSON_FIELD("stepTime",    stepTime,    Int,   BF_STEP_TIME),
+    BREW_JSON_FIELD("pump",        pump,        Bool,  BF_PUMP),
+    BREW_JSON_FIELD("boiler",      boiler,      Bool,  BF_BOILER),
+    BREW_JSON_FIELD("solenoid",    solenoid,    Bool,  BF_SOLENOID),
+    BREW_JSON_FIELD("warmer",      warmer,      Bool,  BF_WARMER),
+    BREW_JSON_FIELD("state",       state,       Str,   BF_STATE),
+};
+
+#undef BREW_JSON_FIELD
+
+static constexpr size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+inline const FieldDef *findField(const char *key, size_t len) {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (FIELDS[i].keyLen == len && memcmp(FIELDS[i].key, key, len) == 0)
+            return &FIELDS[i];
+    }
+    return nullptr;
+}
+
+// Plain decimal -> integer scaled by 10^decimals, rounded on the next
+// digit and saturated to int16. Advances p past the number.
+inline int32_t parseFixed(const char *&p, const char *end, uint8_t decimals) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    int32_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (value < 100000) value = value * 10 + (*p - '0');
+        p++;
+    }
+    uint8_t frac = 0;
+    bool roundUp = false;
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (frac < decimals) {
+                value = value * 10 + (*p - '0');
+                frac++;
+            } else if (frac == decimals) {
+                roundUp = (*p >= '5');
+                frac++;
+            }
+            p++;
+        }
+    }
+    if (frac > decimals) frac = decimals;
+    while (frac < decimals) { value *= 10; frac++; }
+    if (roundUp) value++;
+
+    // Exponents never come from the Pico; skip one if it shows up
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+    }
+
+    if (neg) value = -value;
+    if (value > INT16_MAX) value = INT16_MAX;
+    if (value < INT16_MIN) value = INT16_MIN;
+    return value;
+}
+
+// Whole-number field (the Pico never sends fractions for these)
+inline int parseInt(const char *&p, const char *end) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+    int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (value < 100000000) value = value * 10 + (*p - '0');
+        p++;
+    }
+    while (p < end && *p != ',' && *p != '}' && *p != ' ') p++;  // Drop any fraction
+    return neg ? -value : value;
+}
+
+inline void skipSpace(const char *&p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+}
+
+// Write a scalar field, flagging it dirty only if the bytes changed
+inline void store(BrewStatus &out, const FieldDef &f, const void *v) {
+    uint8_t *dst = reinterpret_cast<uint8_t *>(&out) + f.offset;
+    if (memcmp(dst, v, f.size) != 0) {
+        memcpy(dst, v, f.size);
+        out.dirty |= f.bit;
+    }
+}
+
+// Skip a value we don't have a field for
+inline void skipValue(const char *&p, const char *end) {
+    if (p < end && *p == '"') {
+        p++;
+        while (p < end && *p != '"') p++;
+        if (p < end) p++;
+        return;
+    }
+    while (p < end && *p != ',' && *p != '}') p++;
+}
+
+/**
+ * Parse one status line into `out`.
+ * Returns the number of known fields written (0 = not a status frame).
+ */
+inline int parse(const char *json, size_t len, BrewStatus &out) {
+    if (len > MAX_FRAME_LEN) return 0;
+
+    const char *p = json;
+    const char *end = json + len;
+    int written = 0;
+
+    skipSpace(p, end);
+    if (p >= end || *p != '{') return 0;
+    p++;
+
+    while (p < end) {
+        skipSpace(p, end);
+        if (p < end && *p == ',') { p++; skipSpace(p, end); }
+        if (p >= end || *p == '}') break;
+        if (*p != '"') return written;  // Malformed — keep what we have
+
+        // Key
+        const char *key = ++p;
+        while (p < end && *p != '"') p++;
+        if (p >= end) return written;
+        size_t keyLen = p - key;
+        p++;
+
+        skipSpace(p, end);
+        if (p >= end || *p != ':') return written;
+        p++;
+        skipSpace(p, end);
+
+        const FieldDef *f = findField(key, keyLen);
+        if (!f) { skipValue(p, end); continue; }
+
+        switch (f->type) {
+            case FieldType::Deci:
+            case FieldType::Centi: {
+                int16_t v = parseFixed(p, end, f->type == FieldType::Deci ? 1 : 2);
+                store(out, *f, &v);
+                break;
+            }
+            case FieldType::Int: {
+                int v = parseInt(p, end);
+                store(out, *f, &v);
+                break;
+            }
+            case FieldType::Bool: {
+                bool v = (end - p >= 4 && memcmp(p, "true", 4) == 0);
+                store(out, *f, &v);
+                skipValue(p, end);
+                break;
+            }
+            case FieldType::Str: {
+                const char *s = p;
+                size_t n = 0;
+                if (p < end && *p == '"') {
+                    s = ++p;
+                    while (p < end && *p != '"') p++;
+                    n = p - s;
+                    if (p < end) p++;
+                } else {
+                    skipValue(p, end);
+                }
+                out.setState(s, n);
+                break;
+            }
+        }
+        written++;
+    }
+    return written;
+}
+
+/**
+ * Match a command ack line, {"ack":<seq>} (see PicoProtocol.h).
+ * Returns false, leaving `seq` alone, for anything else.
+ */
+inline bool parseAck(const char *json, size_t len, uint16_t &seq) {
+    const char *p = json;
+    const char *end = json + len;
+
+    skipSpace(p, end);
+    if (p >= end || *p != '{') return false;
+    p++;
+    skipSpace(p, end);
+    if (end - p < 5 || memcmp(p, "\"ack\"", 5) != 0) return false;
+    p += 5;
+    skipSpace(p, end);
+    if (p >= end || *p != ':') return false;
+    p++;
+    skipSpace(p, end);
+    if (p >= end || *p < '0' || *p > '9') return false;
+
+    int v = parseInt(p, end);
+    if (v <= 0 || v > 0xFFFF) return false;
+    seq = (uint16_t)v;
+    return true;
+}
+
+}  // namespace BrewJson
@@ -0,0 +1,206 @@
+/**
+ * BrewLayout.h - BrewScreen's widget table (see Layout.h)
+ *
+ * Widget ids, command slots, the BrewStatus bindings and the 240x320
+ * portrait layout. Moving or restyling a widget, or rebinding it to a
+ * different field, is an edit here; BrewScreen only walks the table.
+ *
+ *   Y=0   Title bar (25px) - "BrewForge" + connection dot
+ *   Y=25  Temperature (70px) - Large temp + target + bar
+ *   Y=95  State (30px) - [step]STATE + timer + relay dots
+ *   Y=125 Buttons (55px) - BREW / STOP
+ *   Y=180 Flow (45px) - Flow rate + volume
+ *   Y=225 Adjust (45px) - -5 / +5 / CAL
+ *   Y=270 Nav (50px) - GRAPH; profiler overlay in its place when enabled,
+ *                      firmware update progress over both while one runs
+ */
+
+#pragma once
+
+#include <string.h>
+
+#include "BrewStatus.h"
+#include "FixedFmt.h"
+#include "GradientBar.h"
+#include "Layout.h"
+
+namespace BrewLayout {
+
+// Widget ids — bit positions in BrewScreen's `invalid`
+struct Ids {
+    enum Widget : uint8_t {
+        W_TITLE, W_CONN,
+        W_TEMP, W_TARGET, W_RATE, W_BAR,
+        W_STATE, W_TIMER, W_PUMP, W_BOILER, W_SOLENOID, W_WARMER,
+        W_BREW, W_STOP, W_TEMPDOWN, W_TEMPUP, W_CAL, W_GRAPH,
+        W_FLOW, W_VOLUME,
+        W_PROF0, W_PROF1, W_PROF2, W_PROF3,
+        W_OTA_LABEL, W_OTA_BAR,
+        W_COUNT
+    };
+
+    // Button callback slots (BrewScreen::setCallbacks)
+    enum Action : uint8_t {
+        A_BREW, A_STOP, A_TEMPDOWN, A_TEMPUP, A_CAL, A_GRAPH,
+        A_COUNT
+    };
+};
+
+static_assert(Ids::W_COUNT <= 32, "widget ids are bits in a 32-bit mask");
+
+static constexpr int16_t SCREEN_W  = 240;
+static constexpr int16_t TITLE_Y   = 0;
+static constexpr int16_t TITLE_H   = 25;
+static constexpr int16_t TEMP_Y    = 25;
+static constexpr int16_t STATE_Y   = 95;
+static constexpr int16_t BUTTONS_Y = 125;
+static constexpr int16_t FLOW_Y    = 180;
+static constexpr int16_t TEMPADJ_Y = 225;
+static constexpr int16_t NAV_Y     = 270;
+
+// --- Bindings ---
+namespace bind {
+
+using FixedFmt::TextBuf;
+using Layout::Role;
+
+inline bool running(const BrewStatus &b) { return b.step >= 1 && b.step <= 7; }
+
+inline void temp(const BrewStatus &b, TextBuf &t) { t.fixed(b.temp, 1, 5).put('C'); }
+
+inline void target(const BrewStatus &b, TextBuf &t) {
+    t.put("Target: ").integer(FixedFmt::roundDiv(b.target, 10)).put('C');
+}
+
+// Rate of change, shown only while a brew step runs
+inline void rate(const BrewStatus &b, TextBuf &t) {
+    if (running(b) && b.tempRate != 0) {
+        t.fixed(FixedFmt::roundDiv(b.tempRate, 10), 1, 0, true).put("/s");
+    }
+}
+
+inline float tempLevel(const BrewStatus &b) {
+    return b.target > 0 ? (float)b.temp / b.target : 0;
+}
+
+// Temperature bar colours by how far below target each column is: red
+// from 5.0 C down, yellow at 2.0 C, green at the target, blended between
+inline void tempGradient(const BrewStatus &b, const ForgeTheme &t, GradientLut &lut) {
+    auto at = [&](int16_t below) -> uint8_t {
+        if (b.target <= 0) return 0;
+        const int32_t i = (int32_t)(GradientLut::SIZE - 1) * (b.target - below) / b.target;
+        return (uint8_t)(i < 0 ? 0 : i);
+    };
+    const GradientLut::Stop stops[] = {
+        { at(50), t.accentRed }, { at(20), t.accentYellow }, { 255, t.accentGreen },
+    };
+    lut.build(stops, 3);
+}
+
+inline void state(const BrewStatus &b, TextBuf &t) {
+    t.put('[').integer(b.step).put(']').put(b.state);
+}
+
+inline Role stateColor(const BrewStatus &b) {
+    if (strcmp(b.state, "IDLE") == 0)    return Role::AccentGreen;
+    if (strcmp(b.state, "BREW") == 0)    return Role::AccentPrimary;
+    if (strcmp(b.state, "PREHEAT") == 0) return Role::AccentYellow;
+    if (strcmp(b.state, "DONE") == 0)    return Role::AccentGreen;
+    return Role::AccentCyan;
+}
+
+inline void timer(const BrewStatus &b, TextBuf &t) {
+    if (b.stepTime > 0) t.integer(b.stepElapsed).put('/').integer(b.stepTime).put('s');
+}
+
+inline void flow(const BrewStatus &b, TextBuf &t) {
+    t.put("Flow ").fixed(b.flow, 1, 4).put(" mL/s");
+}
+
+inline void volume(const BrewStatus &b, TextBuf &t) {
+    t.put("Vol  ").fixed(b.volume, 1, 5).put(" mL");
+}
+
+inline bool connected(const BrewStatus &b) { return b.connected; }
+inline bool pump(const BrewStatus &b)      { return b.pump; }
+inline bool boiler(const BrewStatus &b)    { return b.boiler; }
+inline bool solenoid(const BrewStatus &b)  { return b.solenoid; }
+inline bool warmer(const BrewStatus &b)    { return b.warmer; }
+
+}  // namespace bind
+
+// --- 240x320 portrait ---
+namespace portrait {
+
+using namespace Layout;
+using I = Ids;
+using R = Role;
+
+static constexpr int16_t W = SCREEN_W;
+static constexpr GfxDriver::Datum TL = GfxDriver::DATUM_TL;
+static constexpr GfxDriver::Datum TC = GfxDriver::DATUM_TC;
+static constexpr GfxDriver::Datum TR = GfxDriver::DATUM_TR;
+
+// Relay dots (P B S W)
+static constexpr int16_t DOT_X = W - 70, DOT_Y = STATE_Y + 22, DOT_SPACE = 14;
+
+// In construction order, which is also touch dispatch order
+static constexpr Spec TABLE[] = {
+    // Title bar
+    label(I::W_TITLE, 5, 5, 2, TL, W - 30, R::AccentCyan, R::BgHeader, "BrewForge"),
+    dot(I::W_CONN, W - 15, 12, 5, R::AccentGreen, R::AccentRed, nullptr,
+        { BF_CONNECTED, nullptr, bind::connected }),
+
+    // Temperature
+    readout(I::W_TEMP, W / 2, TEMP_Y + 5, TC, R::AccentPrimary, "  0.0C",
+            { BF_TEMP, bind::temp }),
+    label(I::W_TARGET, W / 2, TEMP_Y + 40, 1, TC, W, R::AccentCyan, R::BgPrimary, "Target: 93C",
+          { BF_TARGET, bind::target }),
+    label(I::W_RATE, W / 2, TEMP_Y + 52, 1, TC, W, R::TextDim, R::BgPrimary, "",
+          { BF_STEP | BF_TEMPRATE, bind::rate, bind::running }),
+    gradient(I::W_BAR, 20, TEMP_Y + 62, W - 40, 6, R::TextDim, R::BgPrimary,
+             { BF_TEMP | BF_TARGET, nullptr, nullptr, bind::tempLevel }),
+
+    // State
+    label(I::W_STATE, 5, STATE_Y + 2, 2, TL, 150, R::AccentGreen, R::BgPrimary, "[0]IDLE",
+          { BF_STEP | BF_STATE, bind::state, nullptr, nullptr, bind::stateColor }),
+    readout(I::W_TIMER, W - 5, STATE_Y + 2, TR, R::TextPrimary, "",
+            { BF_STEP_ELAPSED | BF_STEP_TIME, bind::timer }),
+    dot(I::W_PUMP,     DOT_X,                 DOT_Y, 4, R::AccentGreen,  R::BtnDefault, "P",
+        { BF_PUMP, nullptr, bind::pump }),
+    dot(I::W_BOILER,   DOT_X + DOT_SPACE,     DOT_Y, 4, R::AccentRed,    R::BtnDefault, "B",
+        { BF_BOILER, nullptr, bind::boiler }),
+    dot(I::W_SOLENOID, DOT_X + DOT_SPACE * 2, DOT_Y, 4, R::AccentBlue,   R::BtnDefault, "S",
+        { BF_SOLENOID, nullptr, bind::solenoid }),
+    dot(I::W_WARMER,   DOT_X + DOT_SPACE * 3, DOT_Y, 4, R::AccentYellow, R::BtnDefault, "W",
+        { BF_WARMER, nullptr, bind::warmer }),
+
+    // Buttons
+    button(I::W_BREW, 5,   BUTTONS_Y, 112, 50, "BREW", R::AccentGreen, R::BgPrimary,   3, I::A_BREW),
+    button(I::W_STOP, 123, BUTTONS_Y, 112, 50, "STOP", R::AccentRed,   R::TextPrimary, 3, I::A_STOP),
+
+    // Temp adjust
+    button(I::W_TEMPDOWN, 5,   TEMPADJ_Y, 55,  40, "-5",  R::BtnDefault, R::TextPrimary, 2, I::A_TEMPDOWN),
+    button(I::W_TEMPUP,   65,  TEMPADJ_Y, 55,  40, "+5",  R::BtnDefault, R::TextPrimary, 2, I::A_TEMPUP),
+    button(I::W_CAL,      130, TEMPADJ_Y, 105, 40, "CAL", R::BtnDefault, R::AccentCyan,  2, I::A_CAL),
+
+    // Flow
+    readout(I::W_FLOW,   5, FLOW_Y + 2,  TL, R::AccentCyan, "Flow  0.0 mL/s", { BF_FLOW, bind::flow }),
+    readout(I::W_VOLUME, 5, FLOW_Y + 22, TL, R::AccentCyan, "Vol    0.0 mL",  { BF_VOLUME, bind::volume }),
+
+    // Nav: GRAPH, the profiler overlay (hidden unless enabled from the
+    // console) and firmware update progress, one at a time
+    button(I::W_GRAPH, 5, NAV_Y + 5, 230, 40, "GRAPH", R::BtnDefault, R::AccentCyan, 2, I::A_GRAPH),
+    label(I::W_PROF0, 5, NAV_Y + 4,  1, TL, W - 10, R::TextDim, R::BgPrimary, ""),
+    label(I::W_PROF1, 5, NAV_Y + 15, 1, TL, W - 10, R::TextDim, R::BgPrimary, ""),
+    label(I::W_PROF2, 5, NAV_Y + 26, 1, TL, W - 10, R::TextDim, R::BgPrimary, ""),
+    label(I::W_PROF3, 5, NAV_Y + 37, 1, TL, W - 10, R::TextDim, R::BgPrimary, ""),
+    label(I::W_OTA_LABEL, W / 2, NAV_Y + 8, 2, TC, W - 10, R::AccentYellow, R::BgPrimary, ""),
+    bar(I::W_OTA_BAR, 20, NAV_Y + 30, W - 40, 10, R::AccentYellow, R::BgPrimary),
+};
+
+static_assert(sizeof(TABLE) / sizeof(TABLE[0]) == Ids::W_COUNT, "one entry per widget id");
+
+}  // namespace portrait
+
+}  // namespace BrewLayout
@@ -2,293 +2,479 @@
  * BrewScreen.h - Main brew display screen for BrewForge HMI
  *
  * Shows temperature, brew state, buttons, flow info, relay status.
- * Uses ForgeUI widgets for clean rendering with dirty-flag updates.
+ * Uses ForgeUI widgets for clean rendering with dirty-flag updates:
+ * update() reads the BrewStatus dirty mask, reformats only the widgets fed
+ * by changed fields and marks just those for draw(). An idle machine
+ * produces no redraws at all.
  *
- * Layout (240x320 portrait):
- *   Y=0   Title bar (25px) - "BrewForge" + connection dot
- *   Y=25  Temperature (70px) - Large temp + target + bar
- *   Y=95  State (30px) - [step]STATE + timer + relay dots
- *   Y=125 Buttons (55px) - BREW / STOP
- *   Y=180 Flow (45px) - Flow rate + volume
- *   Y=225 Adjust (45px) - -5 / +5 / CAL
- *   Y=270 Nav (50px) - Reserved
+ * With a Compositor attached, draw() turns the invalidated widgets into
+ * damage rectangles and submits them as a frame that renders off-screen
+ * and transmits asynchronously (see Compositor.h), so labels update without
+ * flicker. Without one it draws widgets directly.
+ *
+ * The temperature, timer, flow and volume readouts are NumericLabels (see
+ * GlyphAtlas.h): fixed-width GLCD cell rows blitted from glyph atlases
+ * rendered when the widgets are built. Only the cells whose character
+ * changed are damaged or drawn. The temperature bar is a GradientBar in
+ * the same way: red to yellow to green from a theme LUT, with only the
+ * columns between the old and new fill edge sent.
+ *
+ * Widgets are built lazily on first entry, in place in a block inside the
+ * screen sized at compile time, and destroyed, atlases freed, if
+ * LazyScreenManager reclaims the screen (LazyScreen.h). Building allocates
+ * nothing but the atlases.
+ *
+ * What the widgets are, where they sit and which BrewStatus fields feed
+ * them is the constexpr table in BrewLayout.h: build() and update() walk
+ * it (Layout.h), so the layout is data rather than code here.
  */
 
 #pragma once
 
 #include <ForgeUI.h>
-#include <functional>
-
-// Forward-declare the BrewStatus struct (defined in main.cpp)
-struct BrewStatus;
+#include <iterator>
+#include <type_traits>
+
+#include "BrewLayout.h"
+#include "BrewStatus.h"
+#include "Compositor.h"
+#include "FixedFmt.h"
+#include "GlyphAtlas.h"
+#include "GradientBar.h"
+#include "LazyScreen.h"
+#include "Layout.h"
+#include "SmallFn.h"
+
+class BrewScreen : public LazyScreen, public CompositorClient, private BrewLayout::Ids {
+public:
+    static constexpr uint8_t OVERLAY_LINES = 4;  // Text lines in the nav overlay
 
-class BrewScreen : public Screen {
 private:
+    using ElementPtr = std::decay_t<decltype(*std::begin(elements))>;
+
+    static constexpr auto &LAYOUT = BrewLayout::portrait::TABLE;
+
+    static constexpr uint32_t W_BUTTONS = Layout::mask(LAYOUT, Layout::Kind::Button);
+    // Screen-owned readouts and bars, which damage only their changed parts
+    static constexpr uint32_t W_DIRECT = Layout::mask(LAYOUT, Layout::Kind::Readout) |
+                                         Layout::mask(LAYOUT, Layout::Kind::Gradient);
+
+    static constexpr uint32_t W_OVERLAY =
+        (1u << W_PROF0) | (1u << W_PROF1) | (1u << W_PROF2) | (1u << W_PROF3);
+
+    static constexpr uint32_t W_NAV =
+        W_OVERLAY | (1u << W_GRAPH) | (1u << W_OTA_LABEL) | (1u << W_OTA_BAR);
+
+    // How long after a touch the buttons keep redrawing their press state
+    static constexpr unsigned long PRESS_FEEDBACK_MS = 400;
+
     // References to shared state
     BrewStatus &brew;
 
-    // Command callbacks
-    std::function<void()> onBrew;
-    std::function<void()> onStop;
-    std::function<void()> onTempDown;
-    std::function<void()> onTempUp;
-    std::function<void()> onCalibrate;
-
-    // --- Widget pointers (owned by Screen::elements via addElement) ---
-    // Title
-    Label*      lblTitle    = nullptr;
-    StatusDot*  dotConn     = nullptr;
-
-    // Temperature
-    Label*      lblTemp     = nullptr;
-    Label*      lblTarget   = nullptr;
-    Label*      lblRate     = nullptr;
-    ProgressBar* barTemp    = nullptr;
-
-    // State
-    Label*      lblState    = nullptr;
-    Label*      lblTimer    = nullptr;
-    StatusDot*  dotPump     = nullptr;
-    StatusDot*  dotBoiler   = nullptr;
-    StatusDot*  dotSolenoid = nullptr;
-    StatusDot*  dotWarmer   = nullptr;
-
-    // Buttons
-    Button*     btnBrew     = nullptr;
-    Button*     btnStop     = nullptr;
-    Button*     btnTempDown = nullptr;
-    Button*     btnTempUp   = nullptr;
-    Button*     btnCal      = nullptr;
-
-    // Flow
-    Label*      lblFlow     = nullptr;
-    Label*      lblVolume   = nullptr;
-
-    // Layout constants
-    static constexpr int16_t TITLE_Y   = 0;
-    static constexpr int16_t TEMP_Y    = 25;
-    static constexpr int16_t STATE_Y   = 95;
-    static constexpr int16_t BUTTONS_Y = 125;
-    static constexpr int16_t FLOW_Y    = 180;
-    static constexpr int16_t TEMPADJ_Y = 225;
+    ElementPtr widgets[W_COUNT] = {};
+    Rect       bounds[W_COUNT] = {};  // Screen area each widget may paint
+    Compositor *compositor = nullptr;
+    TFT_eSPI   *panel = nullptr;        // Direct glyph blits (attachPanel)
+    uint32_t   invalid = 0;         // Widgets to redraw on the next draw()
+    unsigned long lastTouchMs = 0;
+    bool       touchPending = false;
+    bool       overlayOn = false;
+    int8_t     updatePercent = -1;  // Firmware update progress, -1 = none
+    bool       navToggled = false;  // Nav contents swapped since the last draw
+
+    // Command callbacks, by BrewLayout action slot
+    using Callback = SmallFn<void()>;
+    Callback actions[A_COUNT];
+
+    // Every widget build() creates, in the screen object itself
+    static constexpr size_t ARENA_BYTES = Layout::arenaBytes(LAYOUT);
+
+    WidgetStorage<ARENA_BYTES> widgetStorage;
+
+    // --- Numeric readouts (cell-diffed, see GlyphAtlas.h) ---
+    using TempLabel  = NumericLabel<6, 4>;   // " 92.4C"
+    using TimerLabel = NumericLabel<8, 2>;   // "  12/30s"
+    using FlowLabel  = NumericLabel<14, 2>;  // "Flow  1.2 mL/s", "Vol   36.0 mL"
+
+    TempLabel  numTemp;
+    TimerLabel numTimer;
+    FlowLabel  numFlow;
+    FlowLabel  numVolume;
+
+    // --- Temperature bar (column-diffed, see GradientBar.h) ---
+    static constexpr const Layout::Spec &BAR_SPEC = Layout::find(LAYOUT, W_BAR);
+    using TempBar = GradientBar<BAR_SPEC.w, BAR_SPEC.h>;
+
+    GradientLut tempColors;  // Rebuilt when the target moves
+    TempBar     barTemp;
+
+    GlyphAtlas tempGlyphs;   // size 4, accentPrimary
+    GlyphAtlas timerGlyphs;  // size 2, textPrimary
+    GlyphAtlas flowGlyphs;   // size 2, accentCyan
+
+    void track(Widget id, ElementPtr elem, Rect area) {
+        widgets[id] = elem;
+        bounds[id] = area;
+        addElement(elem);
+    }
+
+    void paintBackground(GfxDriver &g, const Rect &band) {
+        g.fillRect(band.x, band.y, band.w, band.h, theme.bgPrimary);
+        if (band.y < BrewLayout::TITLE_Y + BrewLayout::TITLE_H) {
+            g.fillRect(band.x, BrewLayout::TITLE_Y, band.w, BrewLayout::TITLE_H, theme.bgHeader);
+        }
+    }
+
+    void invalidate(Widget id) { invalid |= 1u << id; }
+
+    template <typename T>
+    T *get(uint8_t id) const { return static_cast<T *>(widgets[id]); }
+
+    template <typename L>
+    void trackNumeric(Widget id, L &label) {
+        widgets[id] = nullptr;
+        bounds[id] = label.bounds();
+    }
+
+    // A readout constructed where its table entry puts it
+    template <typename L>
+    static L readoutAt(uint8_t id, const ForgeTheme &t) {
+        const Layout::Spec &s = Layout::find(LAYOUT, id);
+        return L(L::leftFor(s.x, s.datum), s.y, Layout::color(t, s.fg), Layout::color(t, s.bg));
+    }
+
+    template <typename L>
+    void setNumeric(Widget id, L &label, const char *text, bool alignRight = false) {
+        if (label.setText(text, alignRight)) invalidate(id);
+    }
+
+    // The readout for `id` gets `text`
+    void setReadout(uint8_t id, const char *text, bool alignRight) {
+        forEachNumeric([&](Widget w, auto &label) {
+            if (w == id) setNumeric(w, label, text, alignRight);
+        });
+    }
+
+    // Apply `fn` to each screen-owned widget: the readouts and the bar
+    template <typename F>
+    void forEachDirect(F fn) {
+        forEachNumeric(fn);
+        fn(W_BAR, barTemp);
+    }
+
+    // Apply `fn` to each numeric readout with its widget id
+    template <typename F>
+    void forEachNumeric(F fn) {
+        fn(W_TEMP, numTemp);
+        fn(W_TIMER, numTimer);
+        fn(W_FLOW, numFlow);
+        fn(W_VOLUME, numVolume);
+    }
 
 public:
     BrewScreen(GfxDriver &gfx, const ForgeTheme &theme, BrewStatus &status)
-        : Screen(gfx, theme, "BrewForge"), brew(status) {}
+        : LazyScreen(gfx, theme, "BrewForge"), brew(status),
+          numTemp(readoutAt<TempLabel>(W_TEMP, theme)),
+          numTimer(readoutAt<TimerLabel>(W_TIMER, theme)),
+          numFlow(readoutAt<FlowLabel>(W_FLOW, theme)),
+          numVolume(readoutAt<FlowLabel>(W_VOLUME, theme)),
+          barTemp(BAR_SPEC.x, BAR_SPEC.y, Layout::color(theme, BAR_SPEC.fg),
+                  Layout::color(theme, BAR_SPEC.bg), tempColors) {
+        recolorBar();
+    }
 
     // Set command callbacks
     void setCallbacks(
-        std::function<void()> brew_cb,
-        std::function<void()> stop_cb,
-        std::function<void()> tempDown_cb,
-        std::function<void()> tempUp_cb,
-        std::function<void()> cal_cb
+        Callback brew_cb,
+        Callback stop_cb,
+        Callback tempDown_cb,
+        Callback tempUp_cb,
+        Callback cal_cb,
+        Callback graph_cb
     ) {
-        onBrew      = brew_cb;
-        onStop      = stop_cb;
-        onTempDown  = tempDown_cb;
-        onTempUp    = tempUp_cb;
-        onCalibrate = cal_cb;
+        actions[A_BREW]     = brew_cb;
+        actions[A_STOP]     = stop_cb;
+        actions[A_TEMPDOWN] = tempDown_cb;
+        actions[A_TEMPUP]   = tempUp_cb;
+        actions[A_CAL]      = cal_cb;
+        actions[A_GRAPH]    = graph_cb;
+    }
+
+protected:
+    size_t arenaSize() const override { return ARENA_BYTES; }
+    void  *arenaStorage() override { return widgetStorage.bytes; }
+
+    void build() override {
+        for (const Layout::Spec &spec : LAYOUT) {
+            const Widget id = (Widget)spec.id;
+            if (spec.kind == Layout::Kind::Readout) {
+                setReadout(id, spec.text, spec.datum == GfxDriver::DATUM_TR);
+            }
+            if (spec.kind == Layout::Kind::Readout || spec.kind == Layout::Kind::Gradient) {
+                forEachDirect([&](Widget w, auto &part) { if (w == id) trackNumeric(w, part); });
+                continue;
+            }
+
+            ElementPtr elem = Layout::make<ElementPtr>(arena, spec, theme);
+            if (spec.kind == Layout::Kind::Button) {
+                // onClick is ForgeUI's std::function; two pointers fit its
+                // small-object buffer, so no allocation here either
+                static_cast<Button *>(elem)->onClick = [this, s = &spec]() {
+                    if (widgets[s->id]->visible && actions[s->action]) actions[s->action]();
+                };
+            }
+            track(id, elem, Layout::bounds(spec));
+        }
+
+        applyNav();
+        formatUpdate();
+
+        if (panel) buildAtlases();
     }
 
-    void setup() override {
-        int16_t W = theme.screenW;
-
-        // ========== TITLE BAR ==========
-        lblTitle = new Label(5, 5, "BrewForge",
-                             theme.accentCyan, theme.bgHeader, 2);
-        addElement(lblTitle);
-
-        dotConn = new StatusDot(W - 15, 12, 5,
-                                theme.accentGreen, theme.accentRed);
-        addElement(dotConn);
-
-        // ========== TEMPERATURE ==========
-        lblTemp = new Label(W / 2, TEMP_Y + 5, "0.0C",
-                            theme.accentPrimary, theme.bgPrimary,
-                            4, GfxDriver::DATUM_TC, W);
-        addElement(lblTemp);
-
-        lblTarget = new Label(W / 2, TEMP_Y + 40, "Target: 93C",
-                              theme.accentCyan, theme.bgPrimary,
-                              1, GfxDriver::DATUM_TC, W);
-        addElement(lblTarget);
-
-        lblRate = new Label(W / 2, TEMP_Y + 52, "",
-                            theme.textDim, theme.bgPrimary,
-                            1, GfxDriver::DATUM_TC, W);
-        addElement(lblRate);
-
-        barTemp = new ProgressBar(20, TEMP_Y + 62, W - 40, 6,
-                                  theme.accentGreen, theme.bgPrimary,
-                                  theme.textDim, true);
-        addElement(barTemp);
-
-        // ========== STATE ==========
-        lblState = new Label(5, STATE_Y + 2, "[0]IDLE",
-                             theme.accentGreen, theme.bgPrimary,
-                             2, GfxDriver::DATUM_TL, 150);
-        addElement(lblState);
-
-        lblTimer = new Label(W - 5, STATE_Y + 2, "",
-                             theme.textPrimary, theme.bgPrimary,
-                             2, GfxDriver::DATUM_TR, 100);
-        addElement(lblTimer);
-
-        // Relay dots (P B S W)
-        int16_t dotY = STATE_Y + 22;
-        int16_t dotX = W - 70;
-        int16_t dotSpace = 14;
-
-        dotPump     = new StatusDot(dotX,              dotY, 4, theme.accentGreen,  theme.btnDefault, 'P');
-        dotBoiler   = new StatusDot(dotX + dotSpace,   dotY, 4, theme.accentRed,    theme.btnDefault, 'B');
-        dotSolenoid = new StatusDot(dotX + dotSpace*2, dotY, 4, theme.accentBlue,   theme.btnDefault, 'S');
-        dotWarmer   = new StatusDot(dotX + dotSpace*3, dotY, 4, theme.accentYellow, theme.btnDefault, 'W');
-        addElement(dotPump);
-        addElement(dotBoiler);
-        addElement(dotSolenoid);
-        addElement(dotWarmer);
-
-        // ========== BUTTONS ==========
-        btnBrew = new Button(5, BUTTONS_Y, 112, 50, "BREW",
-                             theme.accentGreen, theme.bgPrimary, 3);
-        btnBrew->onClick = [this]() { if (onBrew) onBrew(); };
-        addElement(btnBrew);
-
-        btnStop = new Button(123, BUTTONS_Y, 112, 50, "STOP",
-                             theme.accentRed, theme.textPrimary, 3);
-        btnStop->onClick = [this]() { if (onStop) onStop(); };
-        addElement(btnStop);
-
-        // ========== TEMP ADJUST ==========
-        btnTempDown = new Button(5, TEMPADJ_Y, 55, 40, "-5",
-                                 theme.btnDefault, theme.textPrimary, 2);
-        btnTempDown->onClick = [this]() { if (onTempDown) onTempDown(); };
-        addElement(btnTempDown);
-
-        btnTempUp = new Button(65, TEMPADJ_Y, 55, 40, "+5",
-                               theme.btnDefault, theme.textPrimary, 2);
-        btnTempUp->onClick = [this]() { if (onTempUp) onTempUp(); };
-        addElement(btnTempUp);
-
-        btnCal = new Button(130, TEMPADJ_Y, 105, 40, "CAL",
-                            theme.btnDefault, theme.accentCyan, 2);
-        btnCal->onClick = [this]() { if (onCalibrate) onCalibrate(); };
-        addElement(btnCal);
-
-        // ========== FLOW ==========
-        lblFlow = new Label(5, FLOW_Y + 2, "Flow 0.0 mL/s",
-                            theme.accentCyan, theme.bgPrimary,
-                            2, GfxDriver::DATUM_TL, W);
-        addElement(lblFlow);
-
-        lblVolume = new Label(5, FLOW_Y + 22, "Vol  0.0 mL",
-                              theme.accentCyan, theme.bgPrimary,
-                              2, GfxDriver::DATUM_TL, W);
-        addElement(lblVolume);
+    // The arena is about to be freed; the atlases go with the widgets
+    void teardown() override {
+        for (auto &w : widgets) w = nullptr;
+        invalid = 0;
+
+        forEachNumeric([](Widget, auto &label) { label.setAtlas(nullptr); });
+        tempGlyphs.release();
+        timerGlyphs.release();
+        flowGlyphs.release();
     }
 
-    void onEnter() override {
-        Screen::onEnter();
+private:
+    // One occupant of the nav area at a time: update > overlay > GRAPH
+    void applyNav() {
+        const bool updating = updatePercent >= 0;
+        for (uint8_t i = 0; i < OVERLAY_LINES; i++) {
+            get<Label>(W_PROF0 + i)->setVisible(overlayOn && !updating);
+        }
+        get<Button>(W_GRAPH)->setVisible(!overlayOn && !updating);
+        get<Label>(W_OTA_LABEL)->setVisible(updating);
+        get<ProgressBar>(W_OTA_BAR)->setVisible(updating);
     }
 
-    void update() override {
-        char buf[32];
+    void formatUpdate() {
+        if (updatePercent < 0) return;
+        char buf[16];
+        FixedFmt::TextBuf(buf, sizeof(buf)).put("UPDATING ").integer(updatePercent).put('%');
+        get<Label>(W_OTA_LABEL)->setText(buf);
+        get<ProgressBar>(W_OTA_BAR)->setProgress(updatePercent / 100.0f);
+    }
+
+    void navChanged() {
+        if (!isBuilt()) return;  // build() applies it
+        applyNav();
+        invalid |= W_NAV;
+        navToggled = true;
+        setNeedsRedraw();
+    }
 
-        // --- Title bar ---
-        dotConn->setActive(brew.connected);
+    void recolorBar() {
+        BrewLayout::bind::tempGradient(brew, theme, tempColors);
+        barTemp.recolor();
+    }
 
-        // --- Temperature ---
-        snprintf(buf, sizeof(buf), "%.1fC", brew.temp);
-        lblTemp->setText(buf);
+    // Any atlas that can't be allocated leaves its labels on the
+    // font-renderer path
+    void buildAtlases() {
+        bool ok = tempGlyphs.build(*panel, "0123456789.- C", 4,
+                                   theme.accentPrimary, theme.bgPrimary);
+        ok &= timerGlyphs.build(*panel, "0123456789/s ", 2,
+                                theme.textPrimary, theme.bgPrimary);
+        ok &= flowGlyphs.build(*panel, "0123456789.- FlowVmL/s", 2,
+                               theme.accentCyan, theme.bgPrimary);
+        numTemp.setAtlas(&tempGlyphs);
+        numTimer.setAtlas(&timerGlyphs);
+        numFlow.setAtlas(&flowGlyphs);
+        numVolume.setAtlas(&flowGlyphs);
+
+        Serial.printf("Glyph atlases: %u bytes%s\n",
+                      (unsigned)(tempGlyphs.bytes() + timerGlyphs.bytes() + flowGlyphs.bytes()),
+                      ok ? "" : " (some failed, using font renderer)");
+    }
 
-        snprintf(buf, sizeof(buf), "Target: %.0fC", brew.target);
-        lblTarget->setText(buf);
+public:
+    /**
+     * Allow direct glyph blits to `tft`. The readout glyphs are pre-rendered
+     * whenever the widgets are built, and freed with them.
+     */
+    void attachPanel(TFT_eSPI &tft) {
+        panel = &tft;
+        if (isBuilt()) buildAtlases();
+    }
 
-        // Rate of change
-        if (brew.step >= 1 && brew.step <= 7 && brew.tempRate != 0) {
-            snprintf(buf, sizeof(buf), "%+.1f/s", brew.tempRate);
-            lblRate->setText(buf);
-            lblRate->setVisible(true);
-        } else {
-            lblRate->setText("");
-            lblRate->setVisible(brew.step >= 1 && brew.step <= 7);
+    // Route redraws through an off-screen compositor (nullptr = draw directly)
+    void setCompositor(Compositor *c) {
+        compositor = (c && c->isReady()) ? c : nullptr;
+    }
+
+    // Called by main after a touch is dispatched to this screen
+    void noteTouch(unsigned long now) {
+        lastTouchMs = now;
+        touchPending = true;
+    }
+
+    bool overlayVisible() const { return overlayOn; }
+
+    // Show or hide the text overlay in the nav area
+    void setOverlayVisible(bool on) {
+        if (on == overlayOn) return;
+        overlayOn = on;
+        navChanged();
+    }
+
+    // Firmware update progress in the nav area, 0-100; -1 hides it
+    void setUpdateProgress(int8_t percent) {
+        if (percent == updatePercent) return;
+        const bool toggled = (percent >= 0) != (updatePercent >= 0);
+        updatePercent = percent;
+        if (toggled) {
+            navChanged();
+        } else if (isBuilt()) {
+            invalid |= (1u << W_OTA_LABEL) | (1u << W_OTA_BAR);
+            setNeedsRedraw();
         }
+        if (isBuilt()) formatUpdate();
+    }
 
-        // Temperature bar
-        float ratio = (brew.target > 0) ? (brew.temp / brew.target) : 0;
-        if (ratio > 1.0f) ratio = 1.0f;
-        if (ratio < 0) ratio = 0;
-        barTemp->setProgress(ratio);
-
-        // Bar color based on proximity to target
-        if (brew.temp < brew.target - 5)
-            barTemp->fillColor = theme.accentRed;
-        else if (brew.temp < brew.target - 2)
-            barTemp->fillColor = theme.accentYellow;
-        else
-            barTemp->fillColor = theme.accentGreen;
-
-        // --- State ---
-        snprintf(buf, sizeof(buf), "[%d]%s", brew.step, brew.state);
-        lblState->setText(buf);
-
-        // State color
-        if (strcmp(brew.state, "IDLE") == 0)         lblState->textColor = theme.accentGreen;
-        else if (strcmp(brew.state, "BREW") == 0)     lblState->textColor = theme.accentPrimary;
-        else if (strcmp(brew.state, "PREHEAT") == 0)  lblState->textColor = theme.accentYellow;
-        else if (strcmp(brew.state, "DONE") == 0)     lblState->textColor = theme.accentGreen;
-        else                                          lblState->textColor = theme.accentCyan;
-
-        // Timer
-        if (brew.stepTime > 0) {
-            snprintf(buf, sizeof(buf), "%d/%ds", brew.stepElapsed, brew.stepTime);
-            lblTimer->setText(buf);
-        } else {
-            lblTimer->setText("");
+    void setOverlayLine(uint8_t i, const char *text) {
+        if (i >= OVERLAY_LINES || !isBuilt()) return;
+        Label *line = get<Label>(W_PROF0 + i);
+        line->setText(text);
+        if (line->visible) {
+            invalidate((Widget)(W_PROF0 + i));
+            setNeedsRedraw();
         }
+    }
 
-        // Relay dots
-        dotPump->setActive(brew.pump);
-        dotBoiler->setActive(brew.boiler);
-        dotSolenoid->setActive(brew.solenoid);
-        dotWarmer->setActive(brew.warmer);
+    // Hold-to-repeat only applies to the temperature adjust buttons
+    bool acceptsRepeat(int16_t x, int16_t y) const {
+        Rect p{ x, y, 1, 1 };
+        return p.intersects(bounds[W_TEMPDOWN]) || p.intersects(bounds[W_TEMPUP]);
+    }
+
+    void onEnter() override {
+        LazyScreen::onEnter();
+        brew.dirty = BF_ALL;  // Reformat everything on (re)entry
+    }
 
-        // --- Flow ---
-        snprintf(buf, sizeof(buf), "Flow %.1f mL/s", brew.flow);
-        lblFlow->setText(buf);
-        snprintf(buf, sizeof(buf), "Vol  %.1f mL", brew.volume);
-        lblVolume->setText(buf);
+    void update() override {
+        if (!isBuilt()) return;
+
+        char buf[32];
+        const uint16_t changed = brew.takeDirty();
+
+        // Reformat the widgets fed by changed fields
+        for (const Layout::Spec &spec : LAYOUT) {
+            if (!(changed & spec.bind.fields)) continue;
+            if (spec.kind == Layout::Kind::Gradient) {
+                if (changed & BF_TARGET) recolorBar();
+                if (barTemp.setLevel(spec.bind.level(brew))) invalidate(W_BAR);
+                continue;
+            }
+            if (!Layout::refresh(spec, widgets[spec.id], brew, theme, buf, sizeof(buf))) continue;
+            if (spec.kind == Layout::Kind::Readout) {
+                setReadout(spec.id, buf, spec.datum == GfxDriver::DATUM_TR);
+            } else {
+                invalidate((Widget)spec.id);
+            }
+        }
 
         // --- Button press states ---
-        btnBrew->updatePressState();
-        btnStop->updatePressState();
-        btnTempDown->updatePressState();
-        btnTempUp->updatePressState();
-        btnCal->updatePressState();
+        // Only animate while a press can still be showing
+        for (const Layout::Spec &spec : LAYOUT) {
+            if (spec.kind == Layout::Kind::Button) get<Button>(spec.id)->updatePressState();
+        }
+        if (touchPending) {
+            invalid |= W_BUTTONS;
+            if (millis() - lastTouchMs > PRESS_FEEDBACK_MS) touchPending = false;
+        }
 
-        setNeedsRedraw();
+        if (invalid) setNeedsRedraw();
     }
 
     void draw() override {
-        if (!needsRedraw) return;
+        if (!needsRedraw || !isBuilt()) return;
+
+        if (compositor) {
+            // Previous frame still going out: keep the damage, main calls
+            // draw() again from the frame-complete callback
+            if (compositor->busy()) return;
+            drawComposited();
+        } else {
+            drawDirect();
+        }
+
+        invalid = 0;
+        navToggled = false;
+        needsRedraw = false;
+    }
+
+    // Each band gets its background plus every widget overlapping it,
+    // so hidden widgets are erased and neighbours stay intact
+    void renderBand(GfxDriver &g, TFT_eSprite &canvas, const Rect &band) override {
+        paintBackground(g, band);
+        for (uint8_t i = 0; i < W_COUNT; i++) {
+            ElementPtr elem = widgets[i];
+            if (elem && elem->visible && bounds[i].intersects(band)) {
+                elem->draw(g);
+            }
+        }
+        forEachDirect([&](Widget id, auto &label) {
+            if (bounds[id].intersects(band)) label.drawBand(&canvas, g, band);
+        });
+    }
 
+private:
+    void drawDirect() {
         if (firstDraw) {
             gfx.fillScreen(theme.bgPrimary);
 
             // Draw title bar background
-            gfx.fillRect(0, TITLE_Y, theme.screenW, 25, theme.bgHeader);
+            gfx.fillRect(0, BrewLayout::TITLE_Y, theme.screenW, BrewLayout::TITLE_H, theme.bgHeader);
 
+            invalid = (1u << W_COUNT) - 1;
+            forEachDirect([](Widget, auto &label) { label.invalidate(); });
             firstDraw = false;
         }
 
-        // Draw all elements
-        for (auto elem : elements) {
-            if (elem && elem->visible) {
+        // Widgets don't erase each other: clear the nav when swapping
+        // between the GRAPH button, the overlay and the update bar
+        if (navToggled) {
+            gfx.fillRect(0, BrewLayout::NAV_Y, theme.screenW, theme.screenH - BrewLayout::NAV_Y,
+                         theme.bgPrimary);
+        }
+
+        // Draw only the widgets whose content changed
+        for (uint8_t i = 0; i < W_COUNT; i++) {
+            ElementPtr elem = widgets[i];
+            if ((invalid & (1u << i)) && elem && elem->visible) {
                 elem->draw(gfx);
             }
         }
+        forEachDirect([&](Widget id, auto &label) {
+            if (invalid & (1u << id)) label.draw(panel, gfx);
+        });
+    }
 
-        needsRedraw = false;
+    void drawComposited() {
+        if (firstDraw) {
+            compositor->addFullScreen();
+            firstDraw = false;
+        } else {
+            for (uint8_t i = 0; i < W_COUNT; i++) {
+                if ((invalid & ~W_DIRECT) & (1u << i)) compositor->addDamage(bounds[i]);
+            }
+            // Readouts and the bar only damage the cells / columns that changed
+            forEachDirect([&](Widget id, auto &label) {
+                if (invalid & (1u << id)) compositor->addDamage(label.changedBounds());
+            });
+        }
+        // The frame repaints every damaged cell from its current text
+        forEachDirect([](Widget, auto &label) { label.markShown(); });
+        compositor->submit(this);
+        compositor->pump();
     }
 };
@@ -0,0 +1,105 @@
+/**
+ * BrewStatus.h - Latest machine state reported by the BrewForge Pico
+ *
+ * Filled in by the UART protocol layer (see BrewJson.h) and read by the
+ * screens. Kept as a plain standard-layout struct so the parser's key
+ * table can address fields with offsetof().
+ *
+ * Writers set a BrewField bit in `dirty` for every field whose value
+ * actually changed and bump `seq` once per applied frame. The screen takes
+ * the mask with takeDirty() and only reformats/redraws what it names.
+ * mergeFrom() applies a snapshot from the protocol core the same way, so
+ * the UI's mask stays exact even if it skips intermediate snapshots.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+enum BrewField : uint16_t {
+    BF_TEMP         = 1 << 0,
+    BF_TEMPF        = 1 << 1,
+    BF_TARGET       = 1 << 2,
+    BF_FLOW         = 1 << 3,
+    BF_VOLUME       = 1 << 4,
+    BF_TEMPRATE     = 1 << 5,
+    BF_STEP         = 1 << 6,
+    BF_STEP_ELAPSED = 1 << 7,
+    BF_STEP_TIME    = 1 << 8,
+    BF_PUMP         = 1 << 9,
+    BF_BOILER       = 1 << 10,
+    BF_SOLENOID     = 1 << 11,
+    BF_WARMER       = 1 << 12,
+    BF_STATE        = 1 << 13,
+    BF_CONNECTED    = 1 << 14,
+    BF_ALL          = 0x7FFF,
+};
+
+struct BrewStatus {
+    int16_t temp = 0;        // 0.1 C
+    int16_t tempF = 0;       // 0.1 F
+    int16_t target = 930;    // 0.1 C
+    int16_t flow = 0;        // 0.1 mL/s
+    int16_t volume = 0;      // 0.1 mL
+    char state[16] = "IDLE";
+    int step = 0;
+    int stepElapsed = 0;
+    int stepTime = 0;
+    bool pump = false;
+    bool boiler = false;
+    bool solenoid = false;
+    bool warmer = false;
+    int16_t tempRate = 0;    // 0.01 C/s
+    bool connected = false;
+    unsigned long lastUpdate = 0;
+    uint32_t rxMicros = 0;      // When the last applied frame arrived (profiling)
+
+    uint16_t dirty = BF_ALL;  // BrewField bits changed since last takeDirty()
+    uint32_t seq = 0;         // Frames applied
+
+    template <typename T>
+    void set(T &field, const T &value, uint16_t bit) {
+        if (field != value) {
+            field = value;
+            dirty |= bit;
+        }
+    }
+
+    void setState(const char *s, size_t len) {
+        if (len >= sizeof(state)) len = sizeof(state) - 1;
+        if (strncmp(state, s, len) != 0 || state[len] != '\0') {
+            memcpy(state, s, len);
+            state[len] = '\0';
+            dirty |= BF_STATE;
+        }
+    }
+
+    // Copy another snapshot in, flagging every field that differs
+    void mergeFrom(const BrewStatus &o) {
+        set(temp,        o.temp,        BF_TEMP);
+        set(tempF,       o.tempF,       BF_TEMPF);
+        set(target,      o.target,      BF_TARGET);
+        set(flow,        o.flow,        BF_FLOW);
+        set(volume,      o.volume,      BF_VOLUME);
+        set(tempRate,    o.tempRate,    BF_TEMPRATE);
+        set(step,        o.step,        BF_STEP);
+        set(stepElapsed, o.stepElapsed, BF_STEP_ELAPSED);
+        set(stepTime,    o.stepTime,    BF_STEP_TIME);
+        set(pump,        o.pump,        BF_PUMP);
+        set(boiler,      o.boiler,      BF_BOILER);
+        set(solenoid,    o.solenoid,    BF_SOLENOID);
+        set(warmer,      o.warmer,      BF_WARMER);
+        set(connected,   o.connected,   BF_CONNECTED);
+        setState(o.state, strlen(o.state));
+        lastUpdate = o.lastUpdate;
+        rxMicros = o.rxMicros;
+        seq = o.seq;
+    }
+
+    uint16_t takeDirty() {
+        uint16_t d = dirty;
+        dirty = 0;
+        return d;
+    }
+};
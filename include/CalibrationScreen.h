@@ -2,61 +2,221 @@
  * CalibrationScreen.h - Touch calibration screen for BrewForge HMI
  *
  * 4-corner touch calibration procedure. Draws crosshairs at each corner,
- * captures raw touch coordinates, and computes mapping ranges.
+ * captures raw touch coordinates, and fits the affine map in TouchCal.h.
+ * A fit that is degenerate or misses the targets by more than
+ * MAX_RESIDUAL_PX leaves the old calibration in place and starts over.
  *
- * This screen runs a blocking calibration sequence when entered,
- * then triggers a callback with the results and navigates back.
+ * Runs as a state machine advanced from update(), one step per loop()
+ * pass, so the UART link and the rest of the loop keep running while the
+ * user works through the corners. Each corner takes the median of
+ * SAMPLES readings once the press has settled; lifting early restarts
+ * that corner. On completion a callback fires with the results and main
+ * navigates back.
  *
- * Note: This is somewhat special — it uses blocking waits during
- * calibration (touch.touched() loops). That's fine for a calibration
- * screen that takes full control.
+ * The screen reads the XPT2046 directly while active; main keeps its own
+ * touch dispatch out of the way (see isCalibrating()).
  */
 
 #pragma once
 
 #include <ForgeUI.h>
 #include <XPT2046_Touchscreen.h>
-#include <functional>
-
-struct TouchCal {
-    int16_t xMin = 300;
-    int16_t xMax = 3800;
-    int16_t yMin = 300;
-    int16_t yMax = 3800;
-    bool valid = false;
-};
+
+#include "SmallFn.h"
+#include "TouchCal.h"
 
 class CalibrationScreen : public Screen {
+public:
+    static constexpr uint8_t  SAMPLES        = 8;
+    static constexpr uint32_t SAMPLE_MS      = 10;
+    static constexpr uint32_t SETTLE_MS      = 50;   // Ignore the first contact bounce
+    static constexpr uint32_t RELEASE_HOLD_MS = 300; // Quiet time before the next corner
+    static constexpr int16_t  PRESSURE_MIN   = 200;
+    static constexpr float    MAX_RESIDUAL_PX = 12.0f;
+
 private:
+    enum class CalState : uint8_t {
+        IDLE,           // Not on screen
+        WAIT_PRESS,     // Crosshair shown, waiting for contact
+        SAMPLING,       // Collecting readings for the current corner
+        WAIT_RELEASE,   // Corner captured, waiting for the finger to lift
+        RESULT,         // Showing the result, waiting for a tap
+        RESULT_RELEASE  // Tap seen, waiting for release
+    };
+
+    struct CalPoint { int16_t sx, sy, tx, ty; };
+
     XPT2046_Touchscreen &touch;
     TouchCal &cal;
-    std::function<void()> onComplete;  // Called when calibration finishes
+    SmallFn<void()> onComplete;  // Called when calibration finishes
+
+    CalState state = CalState::IDLE;
+    CalPoint pts[4];
+    uint8_t  corner = 0;
+    uint8_t  nSamples = 0;
+    int16_t  sampleX[SAMPLES];
+    int16_t  sampleY[SAMPLES];
+    uint32_t stateSince = 0;
+    uint32_t lastSample = 0;
+    bool     fitOk = false;
+    float    fitError = 0;
+    CalState pendingDraw = CalState::IDLE;  // Prompt/result still to be drawn
 
 public:
     CalibrationScreen(GfxDriver &gfx, const ForgeTheme &theme,
                       XPT2046_Touchscreen &ts, TouchCal &calData)
         : Screen(gfx, theme, "Calibration"), touch(ts), cal(calData) {}
 
-    void setOnComplete(std::function<void()> cb) {
+    void setOnComplete(SmallFn<void()> cb) {
         onComplete = cb;
     }
 
+    // True while this screen owns the touch panel
+    bool isCalibrating() const { return state != CalState::IDLE; }
+
     void setup() override {
         // No persistent widgets — this screen draws procedurally
     }
 
     void onEnter() override {
         Screen::onEnter();
-        runCalibration();
+        start();
     }
 
-    void update() override {}
+    void update() override {
+        uint32_t now = millis();
+
+        switch (state) {
+            case CalState::IDLE:
+                break;
+
+            case CalState::WAIT_PRESS:
+                if (pressed()) enter(CalState::SAMPLING, now);
+                break;
+
+            case CalState::SAMPLING:
+                sampleCorner(now);
+                break;
+
+            case CalState::WAIT_RELEASE:
+                if (touch.touched()) {
+                    stateSince = now;  // Still held — restart the quiet period
+                } else if (now - stateSince >= RELEASE_HOLD_MS) {
+                    if (++corner < 4) {
+                        enter(CalState::WAIT_PRESS, now);
+                    } else {
+                        computeCalibration();
+                        enter(CalState::RESULT, now);
+                    }
+                }
+                break;
+
+            case CalState::RESULT:
+                if (pressed()) enter(CalState::RESULT_RELEASE, now);
+                break;
+
+            case CalState::RESULT_RELEASE:
+                if (touch.touched()) break;
+                if (!fitOk) {
+                    start();  // Try again from the first corner
+                    break;
+                }
+                state = CalState::IDLE;
+                // Notify completion (main saves it and switches back to brew screen)
+                if (onComplete) onComplete();
+                break;
+        }
+    }
 
     void draw() override {
-        // Drawing handled in runCalibration()
+        if (pendingDraw == CalState::WAIT_PRESS) {
+            drawPrompt();
+        } else if (pendingDraw == CalState::RESULT) {
+            drawResult();
+        }
+        pendingDraw = CalState::IDLE;
     }
 
 private:
+    void start() {
+        pts[0] = { 20,  20,  0, 0 };  // Top-left
+        pts[1] = { 220, 20,  0, 0 };  // Top-right
+        pts[2] = { 220, 300, 0, 0 };  // Bottom-right
+        pts[3] = { 20,  300, 0, 0 };  // Bottom-left
+        corner = 0;
+        enter(CalState::WAIT_PRESS, millis());
+    }
+
+    void enter(CalState s, uint32_t now) {
+        // Only prompts and the result change what's on screen
+        if (s == CalState::WAIT_PRESS || s == CalState::RESULT) pendingDraw = s;
+        state = s;
+        stateSince = now;
+        nSamples = 0;
+    }
+
+    bool pressed() {
+        if (!touch.touched()) return false;
+        return touch.getPoint().z > PRESSURE_MIN;
+    }
+
+    void sampleCorner(uint32_t now) {
+        if (now - stateSince < SETTLE_MS) return;
+        if (now - lastSample < SAMPLE_MS) return;
+        lastSample = now;
+
+        TS_Point p;
+        if (!touch.touched() || (p = touch.getPoint()).z <= PRESSURE_MIN) {
+            // Lifted before we had enough — start this corner over
+            // (the crosshair is still up, so no redraw)
+            state = CalState::WAIT_PRESS;
+            nSamples = 0;
+            return;
+        }
+
+        sampleX[nSamples] = p.x;
+        sampleY[nSamples] = p.y;
+        if (++nSamples < SAMPLES) return;
+
+        CalPoint &c = pts[corner];
+        c.tx = median(sampleX);
+        c.ty = median(sampleY);
+        Serial.printf("Cal[%d] screen(%d,%d) raw(%d,%d) from %d samples\n",
+                      corner, c.sx, c.sy, c.tx, c.ty, SAMPLES);
+
+        enter(CalState::WAIT_RELEASE, now);
+    }
+
+    // Median of the sample buffer (sorts it in place)
+    static int16_t median(int16_t *v) {
+        for (uint8_t i = 1; i < SAMPLES; i++) {
+            int16_t x = v[i];
+            int8_t j = i - 1;
+            while (j >= 0 && v[j] > x) { v[j + 1] = v[j]; j--; }
+            v[j + 1] = x;
+        }
+        return v[SAMPLES / 2];
+    }
+
+    void computeCalibration() {
+        int16_t sx[4], sy[4], rx[4], ry[4];
+        for (uint8_t i = 0; i < 4; i++) {
+            sx[i] = pts[i].sx; sy[i] = pts[i].sy;
+            rx[i] = pts[i].tx; ry[i] = pts[i].ty;
+        }
+
+        TouchCal fit;
+        fitOk = fit.solve(sx, sy, rx, ry, 4);
+        fitError = fitOk ? fit.residual(sx, sy, rx, ry, 4) : 0;
+        if (fitOk && fitError > MAX_RESIDUAL_PX) fitOk = false;
+        if (fitOk) cal = fit;
+
+        Serial.printf("Calibration %s: [%ld %ld %ld / %ld %ld %ld] err=%.1fpx\n",
+                      fitOk ? "ok" : "rejected",
+                      (long)fit.m[0], (long)fit.m[1], (long)fit.m[2],
+                      (long)fit.m[3], (long)fit.m[4], (long)fit.m[5], fitError);
+    }
+
     void drawCrosshair(int16_t sx, int16_t sy) {
         gfx.drawCircle(sx, sy, 10, theme.accentRed);
         gfx.drawCircle(sx, sy, 3, theme.accentRed);
@@ -66,74 +226,36 @@ private:
         gfx.drawLine(sx, sy - 15, sx, sy + 15, theme.accentRed);
     }
 
-    void runCalibration() {
-        struct CalPoint { int16_t sx, sy, tx, ty; };
-        CalPoint pts[4] = {
-            {20,  20,  0, 0},    // Top-left
-            {220, 20,  0, 0},    // Top-right
-            {220, 300, 0, 0},    // Bottom-right
-            {20,  300, 0, 0}     // Bottom-left
-        };
-
-        for (int i = 0; i < 4; i++) {
-            gfx.fillScreen(theme.bgPrimary);
-            gfx.setTextSize(2);
-            gfx.setTextColor(theme.textPrimary, theme.bgPrimary);
-            gfx.setTextDatum(GfxDriver::DATUM_TL);
-
-            char msg[24];
-            snprintf(msg, sizeof(msg), "Touch point %d/4", i + 1);
-            gfx.drawString(msg, 30, 140);
-
-            drawCrosshair(pts[i].sx, pts[i].sy);
-
-            // Wait for touch
-            while (!touch.touched()) delay(10);
-            delay(50);  // Settle
-            TS_Point p = touch.getPoint();
-            pts[i].tx = p.x;
-            pts[i].ty = p.y;
-
-            Serial.printf("Cal[%d] screen(%d,%d) raw(%d,%d) z=%d\n",
-                          i, pts[i].sx, pts[i].sy, p.x, p.y, p.z);
-
-            // Wait for release
-            while (touch.touched()) delay(10);
-            delay(300);
-        }
+    void drawPrompt() {
+        gfx.fillScreen(theme.bgPrimary);
+        gfx.setTextSize(2);
+        gfx.setTextColor(theme.textPrimary, theme.bgPrimary);
+        gfx.setTextDatum(GfxDriver::DATUM_TL);
 
-        // Compute calibration
-        cal.xMin = (pts[0].tx + pts[3].tx) / 2;
-        cal.xMax = (pts[1].tx + pts[2].tx) / 2;
-        cal.yMin = (pts[0].ty + pts[1].ty) / 2;
-        cal.yMax = (pts[2].ty + pts[3].ty) / 2;
-        cal.valid = true;
+        char msg[24];
+        snprintf(msg, sizeof(msg), "Touch point %d/4", corner + 1);
+        gfx.drawString(msg, 30, 140);
 
-        Serial.printf("Calibration: X(%d->%d) Y(%d->%d)\n",
-                      cal.xMin, cal.xMax, cal.yMin, cal.yMax);
+        drawCrosshair(pts[corner].sx, pts[corner].sy);
+    }
 
-        // Show result
+    void drawResult() {
         gfx.fillScreen(theme.bgPrimary);
         gfx.setTextSize(2);
-        gfx.setTextColor(theme.accentGreen, theme.bgPrimary);
+        gfx.setTextColor(fitOk ? theme.accentGreen : theme.accentRed, theme.bgPrimary);
         gfx.setTextDatum(GfxDriver::DATUM_TL);
-        gfx.drawString("Calibration done!", 20, 100);
+        gfx.drawString(fitOk ? "Calibration done!" : "Calibration failed", 20, 100);
 
         gfx.setTextSize(1);
         gfx.setTextColor(theme.textDim, theme.bgPrimary);
 
         char info[32];
-        snprintf(info, sizeof(info), "X: %d -> %d", cal.xMin, cal.xMax);
+        if (fitOk) {
+            snprintf(info, sizeof(info), "Fit error: %.1f px", fitError);
+        } else {
+            snprintf(info, sizeof(info), "Points inconsistent");
+        }
         gfx.drawString(info, 20, 130);
-        snprintf(info, sizeof(info), "Y: %d -> %d", cal.yMin, cal.yMax);
-        gfx.drawString(info, 20, 145);
-        gfx.drawString("Touch to continue...", 20, 170);
-
-        // Wait for touch then release
-        while (!touch.touched()) delay(10);
-        while (touch.touched()) delay(10);
-
-        // Notify completion (main will switch back to brew screen)
-        if (onComplete) onComplete();
+        gfx.drawString(fitOk ? "Touch to continue..." : "Touch to retry...", 20, 170);
     }
 };
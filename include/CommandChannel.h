@@ -0,0 +1,237 @@
+/**
+ * CommandChannel.h - Acked, retried and coalesced commands to the Pico
+ *
+ * The UI hands PicoCommands to the protocol task (through cmdQueue); the
+ * protocol task owns one CommandChannel and feeds it:
+ *
+ *   submit(cmd, now)   queue a command
+ *   onStatus()         a status frame arrived: the link is up
+ *   onAck(seq, now)    an ack frame/line arrived
+ *   poll(now)          every pass: send, resend on timeout
+ *   reset()            the link timed out
+ *
+ * Stop-and-wait: one tagged command is in flight at a time and is resent
+ * with the same seq every ACK_TIMEOUT_MS until acked, MAX_SENDS times in
+ * all. Because the Pico re-acks a repeated seq without re-running it, a
+ * lost ack can't run a command twice and a lost command is simply resent.
+ * A healthy link acks within a few ms, so waiting costs little.
+ *
+ * While a command waits, later ones queue here and target adjustments
+ * merge: five +5 taps behind a busy link go out as one "T+25". STOP jumps
+ * the queue and cancels a queued (unsent) brew, so brew-then-stop can
+ * never end up running the brew last.
+ *
+ * Fallback: if the first command after the link comes up exhausts its
+ * retries without any ack while status frames keep arriving, the Pico is
+ * taken to predate tagged commands. The channel then resends it and
+ * everything after it as the bare op chars ('b', 'x', one '+'/'-' per
+ * TARGET_STEP_C), unacked, as before. A command that dies with the link
+ * proves nothing and is just dropped.
+ *
+ * Nothing is queued while the link is down: a brew tapped then shouldn't
+ * start minutes later when the Pico comes back. reset() drops the command
+ * in flight and the queue, and forgets the fallback, since the Pico may
+ * come back with other firmware; the next command decides afresh.
+ *
+ * Not thread-safe: protocol task only.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "PicoProtocol.h"
+
+struct PicoCommand {
+    char    op = 0;   // PicoProto::CmdOp
+    int16_t arg = 0;  // OP_TARGET: signed whole degrees C
+};
+
+class CommandChannel {
+public:
+    static constexpr uint32_t ACK_TIMEOUT_MS = 250;
+    static constexpr uint8_t  MAX_SENDS      = 4;   // First send + retries
+    static constexpr uint8_t  QUEUE_LEN      = 8;
+    static constexpr int16_t  TARGET_STEP_C  = 5;   // One legacy '+' / '-'
+
+    // Worst case from submit to the Pico acting on a command
+    static constexpr uint32_t MAX_DELIVERY_MS = ACK_TIMEOUT_MS * MAX_SENDS;
+
+private:
+    Print &link;
+    Print &log;
+
+    PicoCommand queue[QUEUE_LEN];
+    uint8_t     queued = 0;
+
+    PicoCommand inflight;
+    bool        busy = false;
+    uint16_t    inflightSeq = 0;
+    uint32_t    sentMs = 0;
+    uint8_t     sends = 0;
+
+    uint16_t nextSeq = 1;
+    bool     linkUp = false;
+    bool     heard = false;      // Status frame since the in-flight command went out
+    bool     everAcked = false;  // Since the last reset()
+    bool     legacy = false;
+
+    static int16_t clamp16(int32_t v) {
+        return v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : (int16_t)v;
+    }
+
+    void removeAt(uint8_t i) {
+        for (; i + 1 < queued; i++) queue[i] = queue[i + 1];
+        queued--;
+    }
+
+    void insertAt(uint8_t i, const PicoCommand &c) {
+        for (uint8_t j = queued; j > i; j--) queue[j] = queue[j - 1];
+        queue[i] = c;
+        queued++;
+    }
+
+    // "C17:T+25"
+    void writeTagged() {
+        char line[16];
+        if (inflight.op == PicoProto::OP_TARGET) {
+            snprintf(line, sizeof(line), "%c%u:%c%+d", PicoProto::CMD_TAG,
+                     (unsigned)inflightSeq, inflight.op, inflight.arg);
+        } else {
+            snprintf(line, sizeof(line), "%c%u:%c", PicoProto::CMD_TAG,
+                     (unsigned)inflightSeq, inflight.op);
+        }
+        link.print(line);
+        link.write('\n');
+        log.printf("[HMI->Pico] %s%s\n", line, sends ? " (retry)" : "");
+    }
+
+    void writeLegacy(const PicoCommand &c) {
+        if (c.op != PicoProto::OP_TARGET) {
+            link.write(c.op);
+            link.write('\n');
+            log.printf("[HMI->Pico] %c\n", c.op);
+            return;
+        }
+        const char ch = c.arg < 0 ? '-' : '+';
+        const int steps = (c.arg < 0 ? -c.arg : c.arg) / TARGET_STEP_C;
+        for (int i = 0; i < steps; i++) {
+            link.write(ch);
+            link.write('\n');
+        }
+        log.printf("[HMI->Pico] %c x%d\n", ch, steps);
+    }
+
+    // Start the next tagged command; untagged ones all go out at once
+    void sendNext(uint32_t now) {
+        while (!busy && queued > 0) {
+            PicoCommand c = queue[0];
+            removeAt(0);
+
+            if (legacy) {
+                writeLegacy(c);
+                continue;
+            }
+
+            inflight = c;
+            inflightSeq = nextSeq;
+            nextSeq = nextSeq == UINT16_MAX ? 1 : nextSeq + 1;
+            sends = 0;
+            busy = true;
+            heard = false;
+            writeTagged();
+            sends = 1;
+            sentMs = now;
+        }
+    }
+
+    void giveUp(uint32_t now) {
+        busy = false;
+        if (!everAcked && heard) {
+            log.println("[HMI->Pico] no acks, falling back to untagged commands");
+            legacy = true;
+            writeLegacy(inflight);
+        } else {
+            log.printf("[HMI->Pico] C%u unacked, dropped\n", (unsigned)inflightSeq);
+        }
+        sendNext(now);
+    }
+
+public:
+    CommandChannel(Print &linkOut, Print &logOut) : link(linkOut), log(logOut) {}
+
+    void submit(const PicoCommand &c, uint32_t now) {
+        if (!linkUp) {
+            log.printf("[HMI->Pico] no link, dropped %c\n", c.op);
+            return;
+        }
+
+        if (c.op == PicoProto::OP_TARGET) {
+            for (uint8_t i = 0; i < queued; i++) {
+                if (queue[i].op != PicoProto::OP_TARGET) continue;
+                queue[i].arg = clamp16((int32_t)queue[i].arg + c.arg);
+                if (queue[i].arg == 0) removeAt(i);  // +5 -5 cancels out
+                return;
+            }
+        }
+
+        if (c.op == PicoProto::OP_STOP) {
+            for (uint8_t i = 0; i < queued;) {
+                if (queue[i].op == PicoProto::OP_BREW) removeAt(i);
+                else i++;
+            }
+        }
+
+        if (queued == QUEUE_LEN) {
+            log.printf("[HMI->Pico] queue full, dropped %c\n", c.op);
+            return;
+        }
+
+        if (c.op == PicoProto::OP_STOP) insertAt(0, c);
+        else insertAt(queued, c);
+        sendNext(now);
+    }
+
+    void onStatus() {
+        linkUp = true;
+        heard = true;
+    }
+
+    void onAck(uint16_t seq, uint32_t now) {
+        if (!busy || seq != inflightSeq) return;  // Late re-ack of an old one
+        busy = false;
+        everAcked = true;
+        sendNext(now);
+    }
+
+    void poll(uint32_t now) {
+        if (busy && now - sentMs >= ACK_TIMEOUT_MS) {
+            if (sends >= MAX_SENDS) {
+                giveUp(now);
+            } else {
+                writeTagged();
+                sends++;
+                sentMs = now;
+            }
+        }
+        sendNext(now);
+    }
+
+    // Link lost: the Pico may have rebooted, possibly into other firmware
+    void reset() {
+        if (busy || queued) {
+            log.printf("[HMI->Pico] link lost, dropped %u command(s)\n",
+                       (unsigned)(queued + (busy ? 1 : 0)));
+        }
+        busy = false;
+        queued = 0;
+        sends = 0;
+        linkUp = false;
+        heard = false;
+        everAcked = false;
+        legacy = false;
+    }
+
+    bool idle() const { return !busy && queued == 0; }
+    bool untagged() const { return legacy; }
+};
@@ -0,0 +1,251 @@
+/**
+ * Compositor.h - Dirty-rectangle compositor for flicker-free redraws
+ *
+ * Screens report the rectangles that changed with addDamage(); overlapping
+ * or touching rectangles are merged. submit() turns them into a frame that
+ * pump() renders off-screen one strip at a time: the client paints the
+ * background and every widget that intersects the strip, and the finished
+ * strip goes out to the panel in a single DMA transfer.
+ *
+ * Two strip buffers alternate, so the next strip renders while the previous
+ * one is still on the wire. pump() does a bounded amount of work per call
+ * and returns without waiting for the transfer, letting loop() keep
+ * servicing UART and touch however much of the screen changed. The
+ * frame-complete callback fires once the last strip has been sent.
+ *
+ * Widgets never draw straight to the ST7789 while the compositor is in use,
+ * so erase-then-redraw flicker disappears and each region costs one SPI
+ * transaction instead of one per widget.
+ *
+ * Each strip is full panel width and STRIP_ROWS tall (240 x 32 x 2 bytes =
+ * 15 KB, two of them), allocated once in internal SRAM — this board has no
+ * PSRAM. Regions narrower than the panel are packed in place before the
+ * push so only the damaged columns cross the bus.
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+#include <drivers/TFT_eSPI_Driver.h>
+
+#include "SmallFn.h"
+
+struct Rect {
+    int16_t x, y, w, h;
+
+    int16_t right() const  { return x + w; }
+    int16_t bottom() const { return y + h; }
+
+    bool empty() const { return w <= 0 || h <= 0; }
+
+    bool intersects(const Rect &o) const {
+        return x < o.right() && o.x < right() && y < o.bottom() && o.y < bottom();
+    }
+
+    // Overlapping or sharing an edge
+    bool touches(const Rect &o) const {
+        return x <= o.right() && o.x <= right() && y <= o.bottom() && o.y <= bottom();
+    }
+
+    Rect united(const Rect &o) const {
+        int16_t l = x < o.x ? x : o.x;
+        int16_t t = y < o.y ? y : o.y;
+        int16_t r = right() > o.right() ? right() : o.right();
+        int16_t b = bottom() > o.bottom() ? bottom() : o.bottom();
+        return { l, t, (int16_t)(r - l), (int16_t)(b - t) };
+    }
+
+    Rect clipped(int16_t W, int16_t H) const {
+        int16_t l = x < 0 ? 0 : x;
+        int16_t t = y < 0 ? 0 : y;
+        int16_t r = right() > W ? W : right();
+        int16_t b = bottom() > H ? H : bottom();
+        return { l, t, (int16_t)(r - l), (int16_t)(b - t) };
+    }
+};
+
+// Implemented by screens that render through the compositor
+class CompositorClient {
+public:
+    virtual ~CompositorClient() {}
+
+    // Paint the background of `band` and every widget intersecting it,
+    // in screen coordinates. `canvas` is the strip sprite behind `g`, for
+    // clients that blit pre-rendered pixels (it clips to the band).
+    virtual void renderBand(GfxDriver &g, TFT_eSprite &canvas, const Rect &band) = 0;
+};
+
+class Compositor {
+public:
+    static constexpr int16_t STRIP_ROWS = 32;
+    static constexpr uint8_t MAX_DAMAGE = 16;
+
+    // Strips rendered per pump() call — bounds how long input waits
+    static constexpr uint8_t STRIPS_PER_PUMP = 2;
+
+private:
+    TFT_eSPI       &tft;
+    TFT_eSprite     stripA;
+    TFT_eSprite     stripB;
+    TFT_eSPI_Driver gfxA;
+    TFT_eSPI_Driver gfxB;
+    TFT_eSprite    *strips[2];
+    TFT_eSPI_Driver *stripGfx[2];
+    int16_t width;
+    int16_t height;
+    bool    ready = false;
+
+    // Damage collected for the next frame
+    Rect    damage[MAX_DAMAGE];
+    uint8_t nDamage = 0;
+
+    // Frame in flight
+    Rect    active[MAX_DAMAGE];
+    uint8_t nActive = 0;
+    uint8_t region = 0;       // Index into active
+    int16_t rowCursor = 0;    // Next screen row of active[region]
+    uint8_t nextStrip = 0;    // Strip buffer to render into next
+    bool    framing = false;
+    CompositorClient *client = nullptr;
+    SmallFn<void()> onFrameComplete;
+
+    // Merge r into the list, folding in anything it now touches
+    void merge(Rect r) {
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (uint8_t i = 0; i < nDamage; i++) {
+                if (damage[i].touches(r)) {
+                    r = r.united(damage[i]);
+                    damage[i] = damage[--nDamage];
+                    grew = true;
+                    break;
+                }
+            }
+        }
+        damage[nDamage++] = r;
+    }
+
+    // Repack a band rendered at full strip width into a contiguous w x rows block
+    uint16_t *packColumns(TFT_eSprite &strip, int16_t x, int16_t w, int16_t rows) {
+        uint16_t *px = (uint16_t *)strip.getPointer();
+        if (x == 0 && w == width) return px;
+        for (int16_t row = 0; row < rows; row++) {
+            memmove(px + row * w, px + row * width + x, w * sizeof(uint16_t));
+        }
+        return px;
+    }
+
+    // Render the next strip and queue it. pushImageDMA() waits for the
+    // previous transfer before starting, which only blocks if rendering
+    // this strip was faster than sending the last one.
+    void renderNextStrip() {
+        const Rect &r = active[region];
+        int16_t y = rowCursor;
+        int16_t rows = r.bottom() - y;
+        if (rows > STRIP_ROWS) rows = STRIP_ROWS;
+
+        TFT_eSprite &strip = *strips[nextStrip];
+
+        // Screen row y lands on strip row 0
+        strip.setViewport(0, -y, width, y + rows);
+        client->renderBand(*stripGfx[nextStrip], strip, Rect{ r.x, y, r.w, rows });
+        strip.resetViewport();
+
+        uint16_t *px = packColumns(strip, r.x, r.w, rows);
+        tft.pushImageDMA(r.x, y, r.w, rows, px);
+        nextStrip ^= 1;
+
+        rowCursor += rows;
+        if (rowCursor >= r.bottom()) {
+            region++;
+            if (region < nActive) rowCursor = active[region].y;
+        }
+    }
+
+public:
+    Compositor(TFT_eSPI &display, int16_t w, int16_t h)
+        : tft(display), stripA(&display), stripB(&display),
+          gfxA(stripA), gfxB(stripB),
+          strips{ &stripA, &stripB }, stripGfx{ &gfxA, &gfxB },
+          width(w), height(h) {}
+
+    // Allocate both strips and enable DMA. Returns false if any of it
+    // fails, in which case screens should keep drawing directly.
+    bool begin() {
+        stripA.setColorDepth(16);
+        stripB.setColorDepth(16);
+        if (!stripA.createSprite(width, STRIP_ROWS) ||
+            !stripB.createSprite(width, STRIP_ROWS) ||
+            !tft.initDMA()) {
+            stripA.deleteSprite();
+            stripB.deleteSprite();
+            return false;
+        }
+        ready = true;
+        return true;
+    }
+
+    bool isReady() const { return ready; }
+
+    // Called once the last strip of a frame has left the SPI bus
+    void setOnFrameComplete(SmallFn<void()> cb) { onFrameComplete = cb; }
+
+    void addDamage(const Rect &r) {
+        Rect c = r.clipped(width, height);
+        if (c.empty()) return;
+        if (nDamage == MAX_DAMAGE) {
+            // Out of slots — collapse everything into one region
+            for (uint8_t i = 1; i < nDamage; i++) damage[0] = damage[0].united(damage[i]);
+            nDamage = 1;
+        }
+        merge(c);
+    }
+
+    void addFullScreen() { addDamage({ 0, 0, width, height }); }
+
+    bool hasDamage() const { return nDamage > 0; }
+
+    // A frame is still rendering or transmitting; the panel's SPI bus is
+    // held, so nothing else may draw directly or read the touch controller
+    // (same SPIClass) until it finishes
+    bool busy() const { return framing; }
+
+    /**
+     * Start sending the collected damage as one frame, rendered by `c`.
+     * Returns false (and keeps the damage) while a frame is in flight.
+     * The work happens in pump().
+     */
+    bool submit(CompositorClient *c) {
+        if (!ready || framing || nDamage == 0) return false;
+
+        memcpy(active, damage, nDamage * sizeof(Rect));
+        nActive = nDamage;
+        nDamage = 0;
+        region = 0;
+        rowCursor = active[0].y;
+        client = c;
+        framing = true;
+
+        tft.startWrite();
+        return true;
+    }
+
+    // Advance the frame in flight by at most STRIPS_PER_PUMP strips.
+    // Call from every loop() pass; never waits for the whole frame.
+    void pump() {
+        if (!framing) return;
+
+        for (uint8_t n = 0; n < STRIPS_PER_PUMP && region < nActive; n++) {
+            renderNextStrip();
+        }
+
+        if (region >= nActive && !tft.dmaBusy()) {
+            tft.endWrite();
+            framing = false;
+            client = nullptr;
+            if (onFrameComplete) onFrameComplete();
+        }
+    }
+};
@@ -0,0 +1,91 @@
+/**
+ * FixedFmt.h - Integer formatting for fixed-point readouts
+ *
+ * BrewStatus keeps measured values as scaled integers (tenths of a degree,
+ * tenths of a mL, ...). TextBuf turns them into text with plain integer
+ * division, so the UI never touches newlib's float printf path (slow, and
+ * heavy on stack) and no float<->string conversion happens anywhere between
+ * the UART and the panel.
+ *
+ *   char buf[16];
+ *   FixedFmt::TextBuf(buf, sizeof(buf)).fixed(brew.temp, 1, 5).put('C');
+ *   // " 92.4C" for temp = 924
+ *
+ * Output is always NUL-terminated and silently truncated at the buffer end.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FixedFmt {
+
+// v / d rounded half away from zero (d > 0)
+constexpr int32_t roundDiv(int32_t v, int32_t d) {
+    return v >= 0 ? (v + d / 2) / d : -((-v + d / 2) / d);
+}
+
+class TextBuf {
+private:
+    char  *start;
+    char  *p;
+    char  *end;  // Last usable byte (holds the terminator)
+
+    // Write the decimal digits of u, at least minDigits of them
+    void digits(uint32_t u, uint8_t minDigits, char *tmp, uint8_t &n) {
+        n = 0;
+        do {
+            tmp[n++] = '0' + u % 10;
+            u /= 10;
+        } while (u || n < minDigits);
+    }
+
+public:
+    TextBuf(char *buf, size_t size) : start(buf), p(buf), end(buf + size - 1) { *p = '\0'; }
+
+    const char *c_str() const { return start; }
+    size_t length() const { return p - start; }
+
+    TextBuf &put(char c) {
+        if (p < end) { *p++ = c; *p = '\0'; }
+        return *this;
+    }
+
+    TextBuf &put(const char *s) {
+        while (*s) put(*s++);
+        return *this;
+    }
+
+    TextBuf &pad(uint8_t n, char c = ' ') {
+        while (n--) put(c);
+        return *this;
+    }
+
+    /**
+     * Write v / 10^decimals with exactly `decimals` places, right-aligned
+     * in `width` characters (0 = no padding). `plus` forces a '+' on
+     * non-negative values.
+     */
+    TextBuf &fixed(int32_t v, uint8_t decimals, uint8_t width = 0, bool plus = false) {
+        char tmp[12];
+        uint8_t n;
+        bool neg = v < 0;
+        uint32_t u = neg ? (uint32_t)(-(int64_t)v) : (uint32_t)v;
+        digits(u, decimals + 1, tmp, n);
+
+        uint8_t len = n + (decimals ? 1 : 0) + ((neg || plus) ? 1 : 0);
+        if (width > len) pad(width - len);
+        if (neg) put('-');
+        else if (plus) put('+');
+        while (n) {
+            if (n == decimals) put('.');
+            put(tmp[--n]);
+        }
+        return *this;
+    }
+
+    TextBuf &integer(int32_t v, uint8_t width = 0) { return fixed(v, 0, width); }
+};
+
+}  // namespace FixedFmt
@@ -0,0 +1,138 @@
+/**
+ * FramePacer.h - Refresh pacing and idle power mode from the brew state
+ *
+ * Three modes, picked each loop pass from BrewStatus and the last touch:
+ *
+ *   ACTIVE  a program step (1-7) is running or the pump is on: refresh
+ *           every 100 ms so timers and press feedback stay crisp
+ *   NORMAL  machine idle but recently touched: the old 250 ms tick
+ *   IDLE    IDLE/DONE (or no Pico) and untouched for IDLE_AFTER_MS: 1 s
+ *           tick, backlight faded down, CPU at 80 MHz
+ *
+ * New status frames always redraw immediately; the mode only sets the
+ * tick for redraws without new data.
+ *
+ * The backlight (GPIO21) runs on LEDC PWM. Dimming fades over about half
+ * a second; waking snaps straight back to full brightness. A touch while
+ * IDLE wakes the screen and is not passed on, so a tap on a dark screen
+ * can't start a shot.
+ *
+ * Touch keeps being polled every loop pass in every mode, so waking is as
+ * fast as any other tap. The ESP32 is not put into light sleep: the UART
+ * is unclocked there and would drop the bytes of the status frame that
+ * woke it, and the Pico streams status continuously. Idle power comes
+ * from the backlight, the lower CPU clock and the idle task's WAITI
+ * between wakeups instead. 80 MHz keeps APB, and so the UART and SPI
+ * clocks, unchanged.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "BrewStatus.h"
+
+enum class PaceMode : uint8_t { ACTIVE, NORMAL, IDLE };
+
+class FramePacer {
+public:
+    static constexpr uint32_t IDLE_AFTER_MS = 60000;
+
+private:
+    struct Profile {
+        uint16_t tickMs;     // Redraw pace without new data
+        uint8_t  backlight;  // LEDC duty, 0-255
+        uint16_t cpuMhz;
+    };
+
+    static constexpr Profile PROFILES[3] = {
+        { 100,  255, 160 },  // ACTIVE
+        { 250,  255, 160 },  // NORMAL
+        { 1000, 40,  80  },  // IDLE
+    };
+
+    static constexpr uint8_t  LEDC_CHANNEL = 0;
+    static constexpr uint32_t LEDC_FREQ_HZ = 5000;  // Above visible flicker
+    static constexpr uint8_t  LEDC_BITS    = 8;
+    static constexpr uint8_t  FADE_STEP    = 4;     // Duty per call while dimming
+
+    PaceMode      current = PaceMode::NORMAL;
+    unsigned long lastActivity = 0;
+    uint8_t       duty = 0;
+    uint8_t       targetDuty = 0;
+
+    static bool busy(const BrewStatus &b) {
+        return (b.step >= 1 && b.step <= 7) || b.pump;
+    }
+
+    static bool resting(const BrewStatus &b) {
+        return !b.connected || strcmp(b.state, "IDLE") == 0 || strcmp(b.state, "DONE") == 0;
+    }
+
+    void setDuty(uint8_t d) {
+        duty = d;
+        ledcWrite(LEDC_CHANNEL, d);
+    }
+
+    void enter(PaceMode m) {
+        if (m == current) return;
+        const Profile &from = PROFILES[(uint8_t)current];
+        const Profile &to = PROFILES[(uint8_t)m];
+        current = m;
+        if (to.cpuMhz != from.cpuMhz) setCpuFrequencyMhz(to.cpuMhz);
+        targetDuty = to.backlight;
+        if (targetDuty > duty) setDuty(targetDuty);  // Brighten at once
+        Serial.printf("[Pace] %s\n", m == PaceMode::ACTIVE ? "active"
+                                   : m == PaceMode::NORMAL ? "normal" : "idle");
+    }
+
+public:
+    // Backlight off; call before the panel shows anything
+    void begin(uint8_t backlightPin) {
+        ledcSetup(LEDC_CHANNEL, LEDC_FREQ_HZ, LEDC_BITS);
+        ledcAttachPin(backlightPin, LEDC_CHANNEL);
+        setDuty(0);
+        targetDuty = 0;
+    }
+
+    // Splash is drawn: light up at the current mode's brightness
+    void start(unsigned long now) {
+        lastActivity = now;
+        targetDuty = PROFILES[(uint8_t)current].backlight;
+        setDuty(targetDuty);
+    }
+
+    /**
+     * A touch arrived. Returns false if it only woke the screen and
+     * should not be dispatched.
+     */
+    bool noteTouch(unsigned long now) {
+        lastActivity = now;
+        if (current != PaceMode::IDLE) return true;
+        enter(PaceMode::NORMAL);
+        return false;
+    }
+
+    // Screen switches and the like count as activity too
+    void noteActivity(unsigned long now) { lastActivity = now; }
+
+    // Pick the mode for this pass and step the backlight fade
+    void update(const BrewStatus &b, unsigned long now) {
+        if (busy(b)) {
+            lastActivity = now;
+            enter(PaceMode::ACTIVE);
+        } else if (resting(b) && now - lastActivity > IDLE_AFTER_MS) {
+            enter(PaceMode::IDLE);
+        } else {
+            enter(PaceMode::NORMAL);
+        }
+
+        if (duty > targetDuty) {
+            setDuty(duty - targetDuty > FADE_STEP ? duty - FADE_STEP : targetDuty);
+        }
+    }
+
+    PaceMode mode() const { return current; }
+    uint16_t tickMs() const { return PROFILES[(uint8_t)current].tickMs; }
+};
@@ -0,0 +1,216 @@
+/**
+ * GlyphAtlas.h - Pre-rendered GLCD glyphs and cell-diffing numeric labels
+ *
+ * GlyphAtlas renders a small character set once at boot, for one text size
+ * and one fg/bg colour pair, into RGB565 cells (in panel byte order, like
+ * sprite memory). After that a character costs a single pushImage() of its
+ * cell, with no font rasterizing at all.
+ *
+ * NumericLabel<CELLS, SIZE> is a fixed-width line of CELLS GLCD cells. Cell
+ * x offsets are constexpr, and setText() compares the new string with what
+ * is on screen cell by cell, so draw() blits only the cells that changed.
+ * One digit of the temperature ticking over is one 24x32 blit instead of
+ * a whole-string render. Callers format values into a fixed width (right
+ * aligned with spaces) so the digits keep their cells.
+ *
+ * Without an atlas (allocation failed, or none attached) a label falls back
+ * to drawing its changed cells through the GfxDriver.
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Compositor.h"
+
+class GlyphAtlas {
+public:
+    static constexpr uint8_t MAX_GLYPHS = 32;
+
+    // GLCD font: 5x7 glyph in a 6x8 cell, scaled by text size
+    static constexpr int16_t cellW(uint8_t size) { return 6 * size; }
+    static constexpr int16_t cellH(uint8_t size) { return 8 * size; }
+
+private:
+    const char *charset = "";
+    uint8_t     count = 0;
+    uint8_t     size = 1;
+    uint16_t   *pixels = nullptr;  // count cells, cellW*cellH each
+    uint16_t    fg = 0, bg = 0;
+
+public:
+    ~GlyphAtlas() { free(pixels); }
+
+    /**
+     * Render every character of `chars` (kept by pointer, so pass a literal)
+     * at text `size` in fg on bg. Returns false if memory ran out; the atlas
+     * then stays empty and labels using it draw through the font renderer.
+     */
+    bool build(TFT_eSPI &tft, const char *chars, uint8_t textSize,
+               uint16_t fgColor, uint16_t bgColor) {
+        size_t n = strlen(chars);
+        if (n > MAX_GLYPHS) n = MAX_GLYPHS;
+
+        const int16_t w = cellW(textSize), h = cellH(textSize);
+        const size_t cellBytes = (size_t)w * h * sizeof(uint16_t);
+
+        uint16_t *buf = (uint16_t *)malloc(n * cellBytes);
+        if (!buf) return false;
+
+        TFT_eSprite cell(&tft);
+        cell.setColorDepth(16);
+        if (!cell.createSprite(w, h)) {
+            free(buf);
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            cell.fillSprite(bgColor);
+            cell.drawChar(0, 0, chars[i], fgColor, bgColor, textSize);
+            memcpy((uint8_t *)buf + i * cellBytes, cell.getPointer(), cellBytes);
+        }
+        cell.deleteSprite();
+
+        free(pixels);
+        pixels = buf;
+        charset = chars;
+        count = n;
+        size = textSize;
+        fg = fgColor;
+        bg = bgColor;
+        return true;
+    }
+
+    // Free the cells; glyph() finds nothing until the next build()
+    void release() {
+        free(pixels);
+        pixels = nullptr;
+        count = 0;
+    }
+
+    bool ready() const { return pixels != nullptr; }
+    uint8_t textSize() const { return size; }
+    uint16_t fgColor() const { return fg; }
+    uint16_t bgColor() const { return bg; }
+
+    // Cell for `c`, or nullptr if it isn't in the set
+    const uint16_t *glyph(char c) const {
+        const char *p = (const char *)memchr(charset, c, count);
+        if (!p) return nullptr;
+        return pixels + (size_t)(p - charset) * cellW(size) * cellH(size);
+    }
+
+    size_t bytes() const { return (size_t)count * cellW(size) * cellH(size) * sizeof(uint16_t); }
+};
+
+template <uint8_t CELLS, uint8_t SIZE>
+class NumericLabel {
+public:
+    static constexpr int16_t CELL_W = GlyphAtlas::cellW(SIZE);
+    static constexpr int16_t CELL_H = GlyphAtlas::cellH(SIZE);
+    static constexpr int16_t WIDTH  = CELLS * CELL_W;
+
+    static constexpr int16_t cellOffset(uint8_t i) { return i * CELL_W; }
+
+    // Left edge for a label of this width anchored like a ForgeUI Label
+    static constexpr int16_t leftFor(int16_t x, GfxDriver::Datum datum) {
+        return datum == GfxDriver::DATUM_TC ? x - WIDTH / 2
+             : datum == GfxDriver::DATUM_TR ? x - WIDTH
+             : x;
+    }
+
+private:
+    int16_t  x, y;
+    uint16_t fg, bg;
+    const GlyphAtlas *atlas = nullptr;
+    char     text[CELLS];           // What the next draw should show
+    char     shown[CELLS];          // What is on the panel
+    uint32_t changed = (1u << CELLS) - 1;
+
+    static_assert(CELLS < 32, "changed mask is 32 bits");
+
+    void drawCell(uint8_t i, TFT_eSPI *canvas, GfxDriver &g) {
+        const int16_t cx = x + cellOffset(i);
+        const uint16_t *px = (atlas && canvas) ? atlas->glyph(text[i]) : nullptr;
+        if (px) {
+            canvas->pushImage(cx, y, CELL_W, CELL_H, px);
+        } else {
+            char s[2] = { text[i], '\0' };
+            g.fillRect(cx, y, CELL_W, CELL_H, bg);
+            g.setTextSize(SIZE);
+            g.setTextColor(fg, bg);
+            g.setTextDatum(GfxDriver::DATUM_TL);
+            g.drawString(s, cx, y);
+        }
+    }
+
+public:
+    NumericLabel(int16_t left, int16_t top, uint16_t fgColor, uint16_t bgColor)
+        : x(left), y(top), fg(fgColor), bg(bgColor) {
+        memset(text, ' ', CELLS);
+        memset(shown, ' ', CELLS);
+    }
+
+    // Use pre-rendered glyphs; the atlas must match this label's size and colours
+    void setAtlas(const GlyphAtlas *a) {
+        atlas = (a && a->ready() && a->textSize() == SIZE &&
+                 a->fgColor() == fg && a->bgColor() == bg) ? a : nullptr;
+    }
+
+    Rect bounds() const { return { x, y, WIDTH, CELL_H }; }
+
+    // Set the cell contents, padded with spaces (on the right unless
+    // alignRight) and truncated to CELLS. Returns true if any cell differs
+    // from what is on screen.
+    bool setText(const char *s, bool alignRight = false) {
+        size_t len = strnlen(s, CELLS);
+        uint8_t pad = alignRight ? CELLS - len : 0;
+        for (uint8_t i = 0; i < CELLS; i++) {
+            text[i] = (i < pad || i >= pad + len) ? ' ' : s[i - pad];
+            if (text[i] != shown[i]) changed |= 1u << i;
+            else changed &= ~(1u << i);
+        }
+        return changed != 0;
+    }
+
+    // Screen area covered by the cells that still need drawing
+    Rect changedBounds() const {
+        if (!changed) return { x, y, 0, 0 };
+        uint8_t first = __builtin_ctz(changed);
+        uint8_t last = 31 - __builtin_clz(changed);
+        return { (int16_t)(x + cellOffset(first)), y,
+                 (int16_t)((last - first + 1) * CELL_W), CELL_H };
+    }
+
+    // Redraw everything on the next draw (first draw, after a full repaint)
+    void invalidate() { changed = (1u << CELLS) - 1; }
+
+    /**
+     * Draw changed cells straight to the panel (or any canvas in screen
+     * coordinates). `canvas` may be null, forcing the font-renderer path.
+     */
+    void draw(TFT_eSPI *canvas, GfxDriver &g) {
+        for (uint8_t i = 0; i < CELLS; i++) {
+            if (changed & (1u << i)) drawCell(i, canvas, g);
+        }
+        memcpy(shown, text, CELLS);
+        changed = 0;
+    }
+
+    // Draw every cell overlapping `band` into a compositor strip. The strip
+    // was just cleared, so unchanged cells are repainted too.
+    void drawBand(TFT_eSPI *canvas, GfxDriver &g, const Rect &band) {
+        for (uint8_t i = 0; i < CELLS; i++) {
+            Rect cell{ (int16_t)(x + cellOffset(i)), y, CELL_W, CELL_H };
+            if (cell.intersects(band)) drawCell(i, canvas, g);
+        }
+    }
+
+    // Compositor frame with this label's damage has been submitted
+    void markShown() {
+        memcpy(shown, text, CELLS);
+        changed = 0;
+    }
+};
@@ -0,0 +1,190 @@
+/**
+ * GradientBar.h - Progress bar filled from a precomputed RGB565 gradient
+ *
+ * GradientLut holds 256 RGB565 colours interpolated between a few theme
+ * colours, stored byte-swapped (panel order, like sprite memory) so they
+ * go to the panel as they are. build() runs only when the stops move.
+ *
+ * GradientBar<W, H> is a W x H bar with a one-pixel border. Each interior
+ * column takes its colour from the LUT by position; recolor() copies them
+ * into a row after the LUT is rebuilt. setLevel() keeps the filled column
+ * count, and draw() sends only the columns between the old and new fill
+ * edge: one address window, then the row segment pushColors()'d once per
+ * pixel row, in a single transaction. With a Compositor it damages just
+ * those columns (changedBounds()) and the strip gets the row segment by
+ * pushImage(), as NumericLabel does its glyphs.
+ *
+ * Without a panel the bar falls back to the GfxDriver, a column at a time.
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+
+#include "Compositor.h"
+
+class GradientLut {
+public:
+    static constexpr uint16_t SIZE = 256;
+
+    struct Stop {
+        uint8_t  at;     // LUT index
+        uint16_t color;  // RGB565, native order
+    };
+
+private:
+    uint16_t px[SIZE] = {};  // Byte-swapped
+
+    static uint16_t swap(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+
+    // Per channel, so the 5/6/5 fields never carry into each other
+    static uint16_t mix(uint16_t a, uint16_t b, uint16_t num, uint16_t den) {
+        auto lerp = [&](int shift, int mask) {
+            const int ca = (a >> shift) & mask, cb = (b >> shift) & mask;
+            return (uint16_t)(((ca + (cb - ca) * (int)num / (int)den) & mask) << shift);
+        };
+        return lerp(11, 0x1F) | lerp(5, 0x3F) | lerp(0, 0x1F);
+    }
+
+public:
+    // `stops` in ascending `at`; before the first and after the last stop
+    // the end colours hold
+    void build(const Stop *stops, uint8_t n) {
+        uint8_t s = 0;
+        for (uint16_t i = 0; i < SIZE; i++) {
+            while (s + 1 < n && i >= stops[s + 1].at) s++;
+            uint16_t c = stops[s].color;
+            if (s + 1 < n && i > stops[s].at) {
+                c = mix(stops[s].color, stops[s + 1].color, i - stops[s].at,
+                        stops[s + 1].at - stops[s].at);
+            }
+            px[i] = swap(c);
+        }
+    }
+
+    uint16_t swapped(uint8_t i) const { return px[i]; }
+    uint16_t native(uint8_t i) const { return swap(px[i]); }
+};
+
+template <int16_t W, int16_t H>
+class GradientBar {
+public:
+    static constexpr int16_t INNER_W = W - 2;
+    static constexpr int16_t INNER_H = H - 2;
+
+    static_assert(INNER_W > 0 && INNER_H > 0, "bar too small for its border");
+
+private:
+    int16_t  x, y;
+    uint16_t border, bg;
+    const GradientLut &lut;
+    uint16_t row[INNER_W];        // Column colours, byte-swapped
+    int16_t  fill = 0;            // Filled columns the next draw should show
+    int16_t  shown = 0;           // ... and on the panel
+    bool     frame = true;        // Border and every column need drawing
+
+    int16_t changedLo() const { return frame ? 0 : (fill < shown ? fill : shown); }
+    int16_t changedHi() const { return frame ? INNER_W : (fill > shown ? fill : shown); }
+
+    void drawBorder(GfxDriver &g) {
+        g.fillRect(x, y, W, 1, border);
+        g.fillRect(x, y + H - 1, W, 1, border);
+        g.fillRect(x, y + 1, 1, INNER_H, border);
+        g.fillRect(x + W - 1, y + 1, 1, INNER_H, border);
+    }
+
+    // Interior columns [lo, hi), rows [top, bottom). `strip`: canvas is a
+    // compositor sprite, which has no address window of its own.
+    void drawColumns(TFT_eSPI *canvas, bool strip, GfxDriver &g, int16_t lo, int16_t hi,
+                     int16_t top, int16_t bottom) {
+        if (lo >= hi || top >= bottom) return;
+        const int16_t left = x + 1;
+        const int16_t filledHi = hi < fill ? hi : fill;
+
+        if (lo < filledHi) {
+            const int16_t n = filledHi - lo;
+            if (canvas && strip) {
+                for (int16_t r = top; r < bottom; r++) canvas->pushImage(left + lo, r, n, 1, row + lo);
+            } else if (canvas) {
+                canvas->startWrite();
+                canvas->setAddrWindow(left + lo, top, n, bottom - top);
+                for (int16_t r = top; r < bottom; r++) canvas->pushColors(row + lo, n, false);
+                canvas->endWrite();
+            } else {
+                for (int16_t c = lo; c < filledHi; c++) {
+                    g.fillRect(left + c, top, 1, bottom - top, lut.native(index(c)));
+                }
+            }
+        }
+        if (filledHi < hi) {
+            const int16_t from = filledHi > lo ? filledHi : lo;
+            g.fillRect(left + from, top, hi - from, bottom - top, bg);
+        }
+    }
+
+    static constexpr uint8_t index(int16_t c) {
+        return (uint8_t)(c * (GradientLut::SIZE - 1) / (INNER_W > 1 ? INNER_W - 1 : 1));
+    }
+
+public:
+    GradientBar(int16_t left, int16_t top, uint16_t borderColor, uint16_t bgColor,
+                const GradientLut &colors)
+        : x(left), y(top), border(borderColor), bg(bgColor), lut(colors) {
+        recolor();
+    }
+
+    // Re-read the LUT after it was rebuilt; all columns repaint on the next draw
+    void recolor() {
+        for (int16_t c = 0; c < INNER_W; c++) row[c] = lut.swapped(index(c));
+        frame = true;
+    }
+
+    Rect bounds() const { return { x, y, W, H }; }
+
+    // Fill to `level` (0..1). Returns true if a column boundary moved.
+    bool setLevel(float level) {
+        if (level < 0) level = 0;
+        if (level > 1.0f) level = 1.0f;
+        fill = (int16_t)(level * INNER_W + 0.5f);
+        return frame || fill != shown;
+    }
+
+    // Draw border and everything on the next draw
+    void invalidate() { frame = true; }
+
+    // Screen area covered by the columns that still need drawing
+    Rect changedBounds() const {
+        if (frame) return bounds();
+        const int16_t lo = changedLo(), hi = changedHi();
+        if (lo >= hi) return { x, y, 0, 0 };
+        return { (int16_t)(x + 1 + lo), (int16_t)(y + 1), (int16_t)(hi - lo), INNER_H };
+    }
+
+    /**
+     * Draw the changed columns straight to the panel. `canvas` may be
+     * null, forcing the GfxDriver path.
+     */
+    void draw(TFT_eSPI *canvas, GfxDriver &g) {
+        if (frame) drawBorder(g);
+        drawColumns(canvas, false, g, changedLo(), changedHi(), y + 1, y + 1 + INNER_H);
+        markShown();
+    }
+
+    // Draw the part overlapping `band` into a compositor strip. The strip
+    // was just cleared to the background.
+    void drawBand(TFT_eSPI *canvas, GfxDriver &g, const Rect &band) {
+        if (!bounds().intersects(band)) return;
+        drawBorder(g);
+        int16_t top = y + 1, bottom = y + 1 + INNER_H;
+        if (top < band.y) top = band.y;
+        if (bottom > band.y + band.h) bottom = band.y + band.h;
+        drawColumns(canvas, true, g, 0, fill, top, bottom);
+    }
+
+    // Drawn, or a compositor frame with this bar's damage was submitted
+    void markShown() {
+        shown = fill;
+        frame = false;
+    }
+};
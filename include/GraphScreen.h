@@ -0,0 +1,295 @@
+/**
+ * GraphScreen.h - Scrolling strip chart of the shot telemetry
+ *
+ * Plots temperature, flow and volume from a TimeSeries as a roll chart:
+ * one panel row per history entry, newest at the bottom. The ST7789's
+ * vertical scroll runs along panel rows, which in this portrait UI is the
+ * screen's y axis, so time runs down the screen and values across it.
+ *
+ * The plot is the panel's scroll area (PanelScroll.h), between the title
+ * bar and the nav bar, which stay fixed. A new entry costs one scroll
+ * register write plus one 240-pixel row written into the line that just
+ * scrolled out of view; the rest of the plot is never redrawn. Entering
+ * the screen, changing zoom or falling more than a screenful behind
+ * repaints the whole plot once. LazyScreenManager undoes the scroll when
+ * another screen is shown.
+ *
+ * ZOOM steps through the history's decimation levels; each row of a
+ * zoomed-out level spans the channel's min..max over its samples.
+ *
+ * Layout (240x320 portrait):
+ *   Y=0   Title bar (25px) - "SHOT" + legend + time window
+ *   Y=25  Plot (245px) - hardware scroll area
+ *   Y=270 Nav (50px) - ZOOM / BACK
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+
+#include "BrewStatus.h"
+#include "FixedFmt.h"
+#include "LazyScreen.h"
+#include "PanelScroll.h"
+#include "SmallFn.h"
+#include "TimeSeries.h"
+
+class GraphScreen : public LazyScreen {
+public:
+    using History = TimeSeries<256, 3>;
+    using Callback = SmallFn<void()>;
+
+    // main samples brew into the history at this period
+    static constexpr uint16_t SAMPLE_MS = 200;
+
+private:
+    // Layout
+    static constexpr int16_t SCREEN_W  = 240;
+    static constexpr int16_t PLOT_Y    = 25;
+    static constexpr int16_t NAV_Y     = 270;
+    static constexpr int16_t PLOT_ROWS = NAV_Y - PLOT_Y;
+
+    static constexpr uint8_t GRID_ROWS = 25;  // Rows between time gridlines
+
+    static constexpr unsigned long PRESS_FEEDBACK_MS = 400;
+
+    // Full-scale value of each plotted channel (fixed point, as in BrewStatus)
+    static constexpr int16_t TEMP_MAX   = 1200;  // 120.0 C
+    static constexpr int16_t FLOW_MAX   = 100;   // 10.0 mL/s
+    static constexpr int16_t VOLUME_MAX = 600;   // 60.0 mL
+
+    TFT_eSPI      &panel;    // Plot rows go straight to panel memory
+    PanelScroll   &scroller;
+    const History &history;
+    BrewStatus    &brew;
+
+    Callback onBack;
+
+    uint8_t  level = 0;          // Zoom: history level on screen
+    uint32_t drawnTotal = 0;     // history.total(level) when last drawn
+    bool     titleDirty = true;
+    bool     touchPending = false;
+    unsigned long lastTouchMs = 0;
+
+    uint16_t line[SCREEN_W];     // One plot row, in panel byte order
+
+    // --- Widgets (in the LazyScreen arena) ---
+    Label  *lblTitle  = nullptr;
+    Label  *lblTemp   = nullptr;
+    Label  *lblFlow   = nullptr;
+    Label  *lblVolume = nullptr;
+    Label  *lblWindow = nullptr;
+    Button *btnZoom   = nullptr;
+    Button *btnBack   = nullptr;
+
+    static constexpr size_t ARENA_BYTES =
+        5 * WidgetArena::slot<Label>() +
+        2 * WidgetArena::slot<Button>();
+
+    // RGB565 as sprite memory holds it (see GlyphAtlas.h)
+    static uint16_t panelOrder(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+
+    static int16_t xFor(int16_t v, int16_t fullScale) {
+        int32_t x = (int32_t)v * (SCREEN_W - 1) / fullScale;
+        return x < 0 ? 0 : x >= SCREEN_W ? SCREEN_W - 1 : (int16_t)x;
+    }
+
+    static int16_t mid(int16_t lo, int16_t hi) { return (int16_t)((lo + hi) / 2); }
+
+    // Min..max of one channel, joined to where the previous row left off
+    void plotSpan(int16_t lo, int16_t hi, int16_t prev, int16_t fullScale, uint16_t color) {
+        int16_t x0 = xFor(lo, fullScale), x1 = xFor(hi, fullScale), xp = xFor(prev, fullScale);
+        if (xp < x0) x0 = xp;
+        if (xp > x1) x1 = xp;
+        const uint16_t c = panelOrder(color);
+        for (int16_t x = x0; x <= x1; x++) line[x] = c;
+    }
+
+    // Render history entry n of the current level into panel row memRow.
+    // Entries no longer (or not yet) held leave a blank, gridded row.
+    void drawRow(int16_t memRow, int64_t n) {
+        const uint16_t bg = panelOrder(theme.bgPrimary);
+        const uint16_t grid = panelOrder(theme.btnDefault);
+        for (int16_t x = 0; x < SCREEN_W; x++) line[x] = bg;
+
+        // Gridlines: every 20 C across, every GRID_ROWS entries down
+        if (n >= 0 && n % GRID_ROWS == 0) {
+            for (int16_t x = 0; x < SCREEN_W; x += 2) line[x] = grid;
+        } else if ((n & 1) == 0) {
+            for (int16_t t = 200; t < TEMP_MAX; t += 200) line[xFor(t, TEMP_MAX)] = grid;
+        }
+
+        const int64_t total = history.total(level);
+        const int64_t oldest = total - history.size(level);
+        if (n >= oldest && n < total) {
+            TelemetrySpan e = history.entry(level, (uint32_t)n);
+            TelemetrySpan p = n > oldest ? history.entry(level, (uint32_t)(n - 1)) : e;
+
+            line[xFor(brew.target, TEMP_MAX)] = panelOrder(theme.accentGreen);
+            plotSpan(e.lo.volume, e.hi.volume, mid(p.lo.volume, p.hi.volume),
+                     VOLUME_MAX, theme.accentYellow);
+            plotSpan(e.lo.flow, e.hi.flow, mid(p.lo.flow, p.hi.flow),
+                     FLOW_MAX, theme.accentCyan);
+            plotSpan(e.lo.temp, e.hi.temp, mid(p.lo.temp, p.hi.temp),
+                     TEMP_MAX, theme.accentPrimary);
+        }
+
+        panel.pushImage(0, memRow, SCREEN_W, 1, line);
+    }
+
+    // Plot rows go through panelRow(), which is the identity without a
+    // scroll area: the plot would paint over the title bar and never
+    // scroll. onEnter() defines it; if it was reset since, say so and
+    // define it again, with a full repaint.
+    void checkScroll() {
+        if (scroller.active() && scroller.areaTop() == PLOT_Y &&
+            scroller.areaRows() == PLOT_ROWS) {
+            return;
+        }
+        Serial.println("[Graph] scroll area lost after entering, redefining");
+        scroller.define(PLOT_Y, PLOT_ROWS);
+        drawnTotal = UINT32_MAX;
+    }
+
+    void redrawPlot() {
+        scroller.scrollTo(0);
+        const int64_t total = history.total(level);
+        for (int16_t i = 0; i < PLOT_ROWS; i++) {
+            drawRow(scroller.panelRow(i), total - PLOT_ROWS + i);
+        }
+        drawnTotal = history.total(level);
+    }
+
+    // Scroll in the entries that arrived since the last draw
+    void appendRows() {
+        const uint32_t total = history.total(level);
+        if (total < drawnTotal || total - drawnTotal >= (uint32_t)PLOT_ROWS) {
+            redrawPlot();  // History cleared, or a screenful behind
+            return;
+        }
+        if (total == drawnTotal) return;
+
+        // Rows that leave the top come back in at the bottom
+        const int16_t n = (int16_t)(total - drawnTotal);
+        scroller.scrollBy(n);
+        for (int16_t i = PLOT_ROWS - n; i < PLOT_ROWS; i++) {
+            drawRow(scroller.panelRow(i), drawnTotal++);
+        }
+    }
+
+    // "x4  196s": zoom factor and the time the plot spans
+    void formatWindow() {
+        char buf[16];
+        const uint32_t seconds = (uint32_t)PLOT_ROWS * History::span(level) * SAMPLE_MS / 1000;
+        FixedFmt::TextBuf(buf, sizeof(buf)).put('x').integer(History::span(level))
+            .put("  ").integer(seconds).put('s');
+        lblWindow->setText(buf);
+        titleDirty = true;
+    }
+
+    void cycleZoom() {
+        level = (level + 1) % History::levelCount();
+        formatWindow();
+        drawnTotal = UINT32_MAX;  // Forces a full repaint at the new level
+        setNeedsRedraw();
+    }
+
+protected:
+    size_t arenaSize() const override { return ARENA_BYTES; }
+
+    void build() override {
+        int16_t W = theme.screenW;
+
+        lblTitle = arena.make<Label>(5, 5, "SHOT", theme.accentCyan, theme.bgHeader, 2);
+        addElement(lblTitle);
+
+        // Legend, in the channel colours
+        lblTemp = arena.make<Label>(62, 9, "temp", theme.accentPrimary, theme.bgHeader, 1);
+        lblFlow = arena.make<Label>(92, 9, "flow", theme.accentCyan, theme.bgHeader, 1);
+        lblVolume = arena.make<Label>(122, 9, "vol", theme.accentYellow, theme.bgHeader, 1);
+        addElement(lblTemp);
+        addElement(lblFlow);
+        addElement(lblVolume);
+
+        lblWindow = arena.make<Label>(W - 5, 9, "", theme.textDim, theme.bgHeader,
+                                      1, GfxDriver::DATUM_TR, 70);
+        addElement(lblWindow);
+
+        btnZoom = arena.make<Button>(5, NAV_Y + 5, 112, 40, "ZOOM",
+                                     theme.btnDefault, theme.textPrimary, 2);
+        btnZoom->onClick = [this]() { cycleZoom(); };
+        addElement(btnZoom);
+
+        btnBack = arena.make<Button>(123, NAV_Y + 5, 112, 40, "BACK",
+                                     theme.btnDefault, theme.accentCyan, 2);
+        btnBack->onClick = [this]() { if (onBack) onBack(); };
+        addElement(btnBack);
+
+        formatWindow();
+    }
+
+    void teardown() override {
+        lblTitle = lblTemp = lblFlow = lblVolume = lblWindow = nullptr;
+        btnZoom = btnBack = nullptr;
+    }
+
+public:
+    GraphScreen(GfxDriver &gfx, const ForgeTheme &theme, TFT_eSPI &tft,
+                PanelScroll &scroll, const History &hist, BrewStatus &status)
+        : LazyScreen(gfx, theme, "Shot"), panel(tft), scroller(scroll),
+          history(hist), brew(status) {}
+
+    void setOnBack(Callback cb) { onBack = cb; }
+
+    // Called by main after a touch is dispatched to this screen
+    void noteTouch(unsigned long now) {
+        lastTouchMs = now;
+        touchPending = true;
+    }
+
+    void onEnter() override {
+        LazyScreen::onEnter();
+        scroller.define(PLOT_Y, PLOT_ROWS);
+    }
+
+    void update() override {
+        if (!isBuilt()) return;
+
+        btnZoom->updatePressState();
+        btnBack->updatePressState();
+        if (touchPending) {
+            setNeedsRedraw();
+            if (millis() - lastTouchMs > PRESS_FEEDBACK_MS) touchPending = false;
+        }
+        if (history.total(level) != drawnTotal || titleDirty) setNeedsRedraw();
+    }
+
+    void draw() override {
+        if (!needsRedraw || !isBuilt()) return;
+        checkScroll();
+
+        if (firstDraw) {
+            gfx.fillScreen(theme.bgPrimary);
+            gfx.fillRect(0, 0, theme.screenW, PLOT_Y, theme.bgHeader);
+            for (auto elem : elements) {
+                if (elem->visible) elem->draw(gfx);
+            }
+            redrawPlot();
+            titleDirty = false;
+            firstDraw = false;
+        } else {
+            if (titleDirty) {
+                lblWindow->draw(gfx);
+                titleDirty = false;
+            }
+            if (touchPending) {
+                btnZoom->draw(gfx);
+                btnBack->draw(gfx);
+            }
+            appendRows();
+        }
+
+        needsRedraw = false;
+    }
+};
@@ -0,0 +1,266 @@
+/**
+ * Layout.h - Screen layouts as constexpr widget tables
+ *
+ * A layout is a constexpr array of Specs, one per widget: kind, id,
+ * position, theme colour roles, initial text and a Binding. The whole
+ * table lives in flash; a screen walks it in build() to construct its
+ * widgets (Layout::make) and in update() to refresh them, so a layout
+ * variant is a new table, not a new screen class.
+ *
+ * A Binding names the BrewStatus dirty bits that affect the widget plus
+ * up to four capture-less functions of BrewStatus:
+ *
+ *   text   Label / Readout text          level  Bar fill, 0..1
+ *   flag   Dot on, Label visible         color  Label text / Bar fill
+ *
+ * Spec fields by kind:
+ *   Label    (x, y) anchored by datum, w = clear width, size = text size
+ *   Dot      centre (x, y), w = radius, fg/bg = on/off, text[0] = letter
+ *   Bar      box (x, y, w, h), fg/bg = fill/background
+ *   Button   box (x, y, w, h), fg/bg = face/caption, action = callback slot
+ *   Readout  (x, y) anchored by datum, fg = text; the screen owns the
+ *            NumericLabel, sized by its type, and right-aligns it for DATUM_TR
+ *   Gradient box (x, y, w, h), fg/bg = border/background; the screen owns
+ *            the GradientBar and feeds it `level`
+ *
+ * arenaBytes(table) sizes a screen's WidgetStorage at compile time;
+ * mask(table, kind) and find(table, id) answer the rest at compile time too.
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "BrewStatus.h"
+#include "Compositor.h"
+#include "FixedFmt.h"
+#include "WidgetArena.h"
+
+namespace Layout {
+
+enum class Kind : uint8_t { Label, Dot, Bar, Button, Readout, Gradient };
+
+// Theme colours by role, so tables don't need a theme instance
+enum class Role : uint8_t {
+    BgPrimary, BgHeader, BtnDefault, TextPrimary, TextDim,
+    AccentPrimary, AccentCyan, AccentGreen, AccentRed, AccentYellow, AccentBlue,
+};
+
+inline uint16_t color(const ForgeTheme &t, Role r) {
+    switch (r) {
+        case Role::BgPrimary:     return t.bgPrimary;
+        case Role::BgHeader:      return t.bgHeader;
+        case Role::BtnDefault:    return t.btnDefault;
+        case Role::TextPrimary:   return t.textPrimary;
+        case Role::TextDim:       return t.textDim;
+        case Role::AccentPrimary: return t.accentPrimary;
+        case Role::AccentCyan:    return t.accentCyan;
+        case Role::AccentGreen:   return t.accentGreen;
+        case Role::AccentRed:     return t.accentRed;
+        case Role::AccentYellow:  return t.accentYellow;
+        case Role::AccentBlue:    return t.accentBlue;
+    }
+    return t.textPrimary;
+}
+
+struct Binding {
+    using TextFn  = void (*)(const BrewStatus &, FixedFmt::TextBuf &);
+    using FlagFn  = bool (*)(const BrewStatus &);
+    using LevelFn = float (*)(const BrewStatus &);
+    using ColorFn = Role (*)(const BrewStatus &);
+
+    uint16_t fields = 0;  // BrewField bits; 0 = static widget
+    TextFn   text   = nullptr;
+    FlagFn   flag   = nullptr;
+    LevelFn  level  = nullptr;
+    ColorFn  color  = nullptr;
+};
+
+static constexpr uint8_t NO_ACTION = 0xFF;
+
+struct Spec {
+    Kind            kind;
+    uint8_t         id;      // The screen's widget id
+    int16_t         x, y, w, h;
+    uint8_t         size;
+    GfxDriver::Datum datum;
+    Role            fg, bg;
+    const char     *text;
+    uint8_t         action;
+    Binding         bind;
+};
+
+// --- Table entries ---
+
+constexpr Spec label(uint8_t id, int16_t x, int16_t y, uint8_t size, GfxDriver::Datum datum,
+                     int16_t w, Role fg, Role bg, const char *text, Binding b = {}) {
+    return { Kind::Label, id, x, y, w, (int16_t)(8 * size), size, datum, fg, bg, text, NO_ACTION, b };
+}
+
+constexpr Spec dot(uint8_t id, int16_t x, int16_t y, int16_t r, Role on, Role off,
+                   const char *letter, Binding b) {
+    return { Kind::Dot, id, x, y, r, r, 0, GfxDriver::DATUM_TL, on, off, letter, NO_ACTION, b };
+}
+
+constexpr Spec bar(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, Role fill, Role bg,
+                   Binding b = {}) {
+    return { Kind::Bar, id, x, y, w, h, 0, GfxDriver::DATUM_TL, fill, bg, nullptr, NO_ACTION, b };
+}
+
+constexpr Spec button(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, const char *text,
+                      Role face, Role caption, uint8_t size, uint8_t action) {
+    return { Kind::Button, id, x, y, w, h, size, GfxDriver::DATUM_TL, face, caption, text, action, {} };
+}
+
+constexpr Spec readout(uint8_t id, int16_t x, int16_t y, GfxDriver::Datum datum, Role fg,
+                       const char *text, Binding b) {
+    return { Kind::Readout, id, x, y, 0, 0, 0, datum, fg, Role::BgPrimary, text, NO_ACTION, b };
+}
+
+constexpr Spec gradient(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, Role border,
+                        Role bg, Binding b) {
+    return { Kind::Gradient, id, x, y, w, h, 0, GfxDriver::DATUM_TL, border, bg, nullptr,
+             NO_ACTION, b };
+}
+
+// --- Compile-time queries ---
+
+template <size_t N>
+constexpr size_t arenaBytes(const Spec (&table)[N]) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < N; i++) {
+        switch (table[i].kind) {
+            case Kind::Label:   bytes += WidgetArena::slot<Label>();       break;
+            case Kind::Dot:     bytes += WidgetArena::slot<StatusDot>();   break;
+            case Kind::Bar:     bytes += WidgetArena::slot<ProgressBar>(); break;
+            case Kind::Button:  bytes += WidgetArena::slot<Button>();      break;
+            case Kind::Readout:
+            case Kind::Gradient: break;
+        }
+    }
+    return bytes;
+}
+
+// Widget ids of one kind, as a bitmask
+template <size_t N>
+constexpr uint32_t mask(const Spec (&table)[N], Kind kind) {
+    uint32_t m = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (table[i].kind == kind) m |= 1u << table[i].id;
+    }
+    return m;
+}
+
+// The entry for widget `id`; the table must have one
+template <size_t N>
+constexpr const Spec &find(const Spec (&table)[N], uint8_t id) {
+    for (size_t i = 0; i < N; i++) {
+        if (table[i].id == id) return table[i];
+    }
+    return table[0];
+}
+
+// Screen area a widget may paint. Labels: GLCD cells are 8px per size step.
+// Dots: the dot plus the letter drawn beside it.
+constexpr Rect bounds(const Spec &s) {
+    switch (s.kind) {
+        case Kind::Label: {
+            int16_t left = s.x;
+            if (s.datum == GfxDriver::DATUM_TC) left = s.x - s.w / 2;
+            else if (s.datum == GfxDriver::DATUM_TR) left = s.x - s.w;
+            return { left, s.y, s.w, s.h };
+        }
+        case Kind::Dot:
+            return { (int16_t)(s.x - s.w - 1), (int16_t)(s.y - s.w - 1),
+                     (int16_t)(2 * s.w + 9), (int16_t)(2 * s.w + 10) };
+        case Kind::Bar:
+        case Kind::Button:
+        case Kind::Gradient:
+            return { s.x, s.y, s.w, s.h };
+        case Kind::Readout:
+            break;
+    }
+    return { 0, 0, 0, 0 };
+}
+
+// --- Runtime ---
+
+// ForgeUI's element base is only named through Screen::elements, so the
+// runtime half takes the screen's element pointer type as Ptr.
+
+// Construct the widget for one ForgeUI-backed spec in `arena`
+template <typename Ptr>
+Ptr make(WidgetArena &arena, const Spec &s, const ForgeTheme &t) {
+    switch (s.kind) {
+        case Kind::Label:
+            return arena.make<Label>(s.x, s.y, s.text, color(t, s.fg), color(t, s.bg),
+                                     s.size, s.datum, s.w);
+        case Kind::Dot:
+            if (s.text && s.text[0]) {
+                return arena.make<StatusDot>(s.x, s.y, s.w, color(t, s.fg), color(t, s.bg),
+                                             s.text[0]);
+            }
+            return arena.make<StatusDot>(s.x, s.y, s.w, color(t, s.fg), color(t, s.bg));
+        case Kind::Bar:
+            return arena.make<ProgressBar>(s.x, s.y, s.w, s.h, color(t, s.fg), color(t, s.bg),
+                                           t.textDim, true);
+        case Kind::Button:
+            return arena.make<Button>(s.x, s.y, s.w, s.h, s.text, color(t, s.fg),
+                                      color(t, s.bg), s.size);
+        case Kind::Readout:
+        case Kind::Gradient:
+            break;
+    }
+    return nullptr;
+}
+
+/**
+ * Apply a spec's binding to its widget. Readouts are the screen's own
+ * (the text is left in `buf` for it), as are gradient bars (nothing is
+ * done for them). Returns true if anything was set.
+ */
+template <typename Ptr>
+bool refresh(const Spec &s, Ptr elem, const BrewStatus &b,
+             const ForgeTheme &t, char *buf, size_t bufLen) {
+    const Binding &bind = s.bind;
+    switch (s.kind) {
+        case Kind::Label: {
+            auto *l = static_cast<Label *>(elem);
+            if (bind.text) {
+                FixedFmt::TextBuf tb(buf, bufLen);
+                bind.text(b, tb);
+                l->setText(buf);
+            }
+            if (bind.flag) l->setVisible(bind.flag(b));
+            if (bind.color) l->textColor = color(t, bind.color(b));
+            return true;
+        }
+        case Kind::Dot:
+            if (!bind.flag) return false;
+            static_cast<StatusDot *>(elem)->setActive(bind.flag(b));
+            return true;
+        case Kind::Bar: {
+            auto *p = static_cast<ProgressBar *>(elem);
+            if (bind.level) {
+                float v = bind.level(b);
+                p->setProgress(v < 0 ? 0 : v > 1.0f ? 1.0f : v);
+            }
+            if (bind.color) p->fillColor = color(t, bind.color(b));
+            return true;
+        }
+        case Kind::Readout: {
+            if (!bind.text) return false;
+            FixedFmt::TextBuf tb(buf, bufLen);
+            bind.text(b, tb);
+            return true;
+        }
+        case Kind::Button:
+        case Kind::Gradient:
+            break;
+    }
+    return false;
+}
+
+}  // namespace Layout
@@ -0,0 +1,169 @@
+/**
+ * LazyScreen.h - Screens that build their widgets on demand
+ *
+ * A LazyScreen does nothing in setup(). The first onEnter() calls build(),
+ * which creates the widgets out of the screen's WidgetArena. While the
+ * screen is off-screen, LazyScreenManager::reclaim() may call release():
+ * the element list is cleared, the screen forgets its widget pointers via
+ * teardown(), and the arena destroys the widgets and frees its block in one
+ * go. The next onEnter() builds it again. A screen that supplies inline
+ * WidgetStorage keeps that block; release() then frees only what
+ * teardown() gives back (caches, atlases).
+ *
+ * LazyScreenManager wraps ForgeUI's ScreenManager and tracks which screen
+ * is showing, so it knows how long every other screen has been idle and
+ * can tell a LazyScreen when it is replaced (onLeave()). It also owns the
+ * panel's hardware scroll state: any scroll a screen set up is undone when
+ * another screen is shown. Use it exactly like ScreenManager; screens that
+ * aren't LazyScreens are simply never reclaimed.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ForgeUI.h>
+
+#include "PanelScroll.h"
+#include "WidgetArena.h"
+
+class LazyScreen : public Screen {
+private:
+    bool built = false;
+
+protected:
+    WidgetArena arena;
+
+    // Bytes to reserve up front for this screen's widgets
+    virtual size_t arenaSize() const = 0;
+
+    // Inline block of arenaSize() bytes (a WidgetStorage), or nullptr to
+    // malloc the block on build and free it on release
+    virtual void *arenaStorage() { return nullptr; }
+
+    // Create widgets with arena.make<T>() and add them as elements
+    virtual void build() = 0;
+
+    // Drop any pointers into the arena (it is about to be freed)
+    virtual void teardown() {}
+
+public:
+    LazyScreen(GfxDriver &gfx, const ForgeTheme &theme, const char *title)
+        : Screen(gfx, theme, title) {}
+
+    // Empty the element list before the arena (and its widgets) goes away
+    ~LazyScreen() { release(); }
+
+    void setup() override {
+        // Widgets are built on first entry — see ensureBuilt()
+    }
+
+    bool isBuilt() const { return built; }
+
+    void ensureBuilt() {
+        if (built) return;
+        if (void *storage = arenaStorage()) {
+            arena.adopt(storage, arenaSize());
+        } else if (!arena.reserve(arenaSize())) {
+            Serial.printf("[Screen] arena of %u bytes unavailable, widgets go on the heap\n",
+                          (unsigned)arenaSize());
+        }
+        build();
+        built = true;
+        if (arena.overflowed()) {
+            Serial.printf("[Screen] widgets outgrew the %u byte arena\n",
+                          (unsigned)arena.bytesReserved());
+        }
+    }
+
+    void release() {
+        if (!built) return;
+        teardown();
+        elements.clear();
+        arena.release();
+        built = false;
+    }
+
+    void onEnter() override {
+        ensureBuilt();
+        Screen::onEnter();
+    }
+
+    // Another screen has been shown in place of this one
+    virtual void onLeave() {}
+};
+
+class LazyScreenManager : public ScreenManager {
+public:
+    static constexpr uint8_t  MAX_SCREENS = 8;
+    static constexpr uint32_t RECLAIM_IDLE_MS = 30000;
+
+private:
+    LazyScreen *lazy[MAX_SCREENS] = {};
+    uint32_t    leftAt[MAX_SCREENS] = {};
+    int         current = -1;
+    int         pending = -1;
+    PanelScroll *scroll = nullptr;
+
+    void track(int idx, LazyScreen *s) {
+        if (idx >= 0 && idx < MAX_SCREENS) lazy[idx] = s;
+    }
+
+    // Before the switch: the new screen's onEnter() runs inside
+    // ScreenManager and may define a scroll of its own, which a reset
+    // after the switch would wipe out
+    void leaving(int idx) {
+        if (current >= 0 && current < MAX_SCREENS && current != idx) {
+            leftAt[current] = millis();
+            if (lazy[current]) lazy[current]->onLeave();
+            // Screens draw in screen coordinates unless they scroll themselves
+            if (scroll) scroll->reset();
+        }
+    }
+
+public:
+    // Reset on every screen switch, before the new screen's onEnter()
+    void setPanelScroll(PanelScroll *s) { scroll = s; }
+
+    int addScreen(Screen *s) {
+        return ScreenManager::addScreen(s);
+    }
+
+    int addScreen(LazyScreen *s) {
+        int idx = ScreenManager::addScreen(s);
+        track(idx, s);
+        return idx;
+    }
+
+    void showScreen(int idx) {
+        leaving(idx);
+        ScreenManager::showScreen(idx);
+        current = idx;
+    }
+
+    void deferShowScreen(int idx) {
+        pending = idx;
+        ScreenManager::deferShowScreen(idx);
+    }
+
+    void processDeferredActions() {
+        const int next = pending;
+        if (next >= 0) leaving(next);
+        ScreenManager::processDeferredActions();
+        if (next >= 0) {
+            current = next;
+            pending = -1;
+        }
+    }
+
+    int currentScreen() const { return current; }
+
+    // Free the widgets of screens idle for longer than idleMs.
+    // Never touches the current screen or one about to be shown.
+    void reclaim(uint32_t now, uint32_t idleMs = RECLAIM_IDLE_MS) {
+        for (int i = 0; i < MAX_SCREENS; i++) {
+            LazyScreen *s = lazy[i];
+            if (!s || i == current || i == pending || !s->isBuilt()) continue;
+            if (now - leftAt[i] >= idleMs) s->release();
+        }
+    }
+};
@@ -0,0 +1,272 @@
+/**
+ * NetBridge.h - Optional MQTT telemetry uplink for shop-wide monitoring
+ *
+ * Built only in the esp32dev-net environment (BREW_NET=1); the default
+ * firmware carries no WiFi stack. The bridge runs as a low-priority task on
+ * core 0 and publishes, per machine:
+ *
+ *   brewforge/<id>/status  BrewStatus snapshot, retained, every PUBLISH_MS
+ *   brewforge/<id>/shot    summary of each finished shot
+ *   brewforge/<id>/online  "1" while connected, "0" as the last will
+ *
+ * With BREW_OTA it also serves firmware updates (OtaUpdate.h).
+ *
+ * <id> is "bf-" plus the low three bytes of the WiFi MAC.
+ *
+ * Nothing else ever waits on the network:
+ *   - status is read from statusChannel, the protocol task's seqlock, at
+ *     publish time. A status the broker never saw is just superseded.
+ *   - shot summaries come from the UI through a LossyRing. While the
+ *     broker is slow or away, the oldest pending summaries are overwritten
+ *     and counted, and the UI's push never fails or waits. A summary the
+ *     broker refused stays queued for the next pass.
+ *   - connecting and publishing happen only in this task, which sits below
+ *     the protocol task's priority on core 0. That also keeps the seqlock
+ *     read safe on the writer's core: the writer can't be preempted by it.
+ *
+ * Configured in include/credentials.h (git-ignored, copy
+ * credentials.h.example):
+ *   BREW_NET_SSID / BREW_NET_PASS     access point; none: stay offline
+ *   BREW_MQTT_HOST                    broker
+ * and with build flags (see platformio.ini):
+ *   BREW_MQTT_PORT                    broker port
+ *   BREW_NET_PUBLISH_MS               status period; 20 machines at the
+ *                                     default 2 s is ~10 msg/s on the broker
+ *   BREW_NET_FULL                     0: compact status (~100 bytes), 1: every field
+ */
+
+#pragma once
+
+#if BREW_NET
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include <WiFi.h>
+
+#include "BrewStatus.h"
+#include "FixedFmt.h"
+#include "OtaUpdate.h"
+#include "Spsc.h"
+#include "TimeSeries.h"
+
+// Access point, broker and OTA password; untracked, see credentials.h.example
+#if __has_include("credentials.h")
+#include "credentials.h"
+#endif
+
+#ifndef BREW_NET_SSID
+#define BREW_NET_SSID ""
+#endif
+#ifndef BREW_NET_PASS
+#define BREW_NET_PASS ""
+#endif
+#ifndef BREW_MQTT_HOST
+#define BREW_MQTT_HOST ""
+#endif
+#ifndef BREW_MQTT_PORT
+#define BREW_MQTT_PORT 1883
+#endif
+#ifndef BREW_NET_PUBLISH_MS
+#define BREW_NET_PUBLISH_MS 2000
+#endif
+#ifndef BREW_NET_FULL
+#define BREW_NET_FULL 0
+#endif
+
+struct NetShot {
+    uint32_t shot;       // ShotLog number
+    uint16_t durationS;
+    int16_t  target;     // 0.1 C
+    int16_t  peakTemp;   // 0.1 C
+    int16_t  peakFlow;   // 0.1 mL/s
+    int16_t  volume;     // 0.1 mL
+};
+
+class NetBridge {
+public:
+    static constexpr uint32_t PUBLISH_MS   = BREW_NET_PUBLISH_MS;
+    static constexpr uint32_t RECONNECT_MS = 5000;
+    static constexpr uint32_t TICK_MS      = 100;
+    static constexpr size_t   MAX_PAYLOAD  = 320;
+    static constexpr size_t   SHOT_QUEUE   = 8;
+
+    // Peaks over a finished shot, from the history level that holds all of it
+    template <uint16_t N, uint8_t LEVELS>
+    static NetShot summarize(const TimeSeries<N, LEVELS> &history, uint16_t sampleMs,
+                             uint32_t shot, int16_t target, int16_t volume) {
+        uint8_t level = 0;
+        while (level + 1 < LEVELS && history.total(level) > history.size(level)) level++;
+
+        NetShot s = { shot, (uint16_t)(history.total(0) * sampleMs / 1000), target,
+                      INT16_MIN, INT16_MIN, volume };
+        for (uint16_t i = 0; i < history.size(level); i++) {
+            const TelemetrySpan e = history.at(level, i);
+            if (e.hi.temp > s.peakTemp) s.peakTemp = e.hi.temp;
+            if (e.hi.flow > s.peakFlow) s.peakFlow = e.hi.flow;
+        }
+        if (history.size(level) == 0) s.peakTemp = s.peakFlow = 0;
+        return s;
+    }
+
+private:
+    const SeqLock<BrewStatus> &status;
+    Print &log;
+
+    WiFiClient   wifi;
+    PubSubClient mqtt;
+
+#if BREW_OTA
+    OtaUpdate *ota = nullptr;
+#endif
+
+    LossyRing<NetShot, SHOT_QUEUE> shots;
+    uint32_t shotsDroppedReported = 0;
+
+    char id[12];
+    char topicStatus[32];
+    char topicShot[32];
+    char topicOnline[32];
+    char payload[MAX_PAYLOAD];
+
+    uint32_t      publishedVersion = 0;
+    unsigned long lastPublish = 0;
+    unsigned long lastConnectTry = 0;
+    bool          wasConnected = false;
+
+    static void deci(FixedFmt::TextBuf &b, const char *key, int32_t v, uint8_t decimals = 1) {
+        b.put(",\"").put(key).put("\":").fixed(v, decimals);
+    }
+
+    static void flag(FixedFmt::TextBuf &b, const char *key, bool v) {
+        b.put(",\"").put(key).put("\":").put(v ? "true" : "false");
+    }
+
+    // Same keys and units as the Pico's JSON frames (BrewJson.h)
+    const char *formatStatus(const BrewStatus &s) {
+        FixedFmt::TextBuf b(payload, sizeof(payload));
+        b.put("{\"state\":\"").put(s.state).put('"');
+        deci(b, "temp", s.temp);
+        deci(b, "target", s.target);
+        deci(b, "flow", s.flow);
+        deci(b, "volume", s.volume);
+        b.put(",\"step\":").integer(s.step);
+        flag(b, "connected", s.connected);
+#if BREW_NET_FULL
+        deci(b, "tempF", s.tempF);
+        deci(b, "tempRate", s.tempRate, 2);
+        b.put(",\"stepElapsed\":").integer(s.stepElapsed);
+        b.put(",\"stepTime\":").integer(s.stepTime);
+        flag(b, "pump", s.pump);
+        flag(b, "boiler", s.boiler);
+        flag(b, "solenoid", s.solenoid);
+        flag(b, "warmer", s.warmer);
+#endif
+        b.put('}');
+        return b.c_str();
+    }
+
+    const char *formatShot(const NetShot &s) {
+        FixedFmt::TextBuf b(payload, sizeof(payload));
+        b.put("{\"shot\":").integer((int32_t)s.shot);
+        b.put(",\"duration\":").integer(s.durationS);
+        deci(b, "target", s.target);
+        deci(b, "peakTemp", s.peakTemp);
+        deci(b, "peakFlow", s.peakFlow);
+        deci(b, "volume", s.volume);
+        b.put('}');
+        return b.c_str();
+    }
+
+    void connect(unsigned long now) {
+        lastConnectTry = now;
+        if (!mqtt.connect(id, topicOnline, 0, true, "0")) {
+            log.printf("[Net] broker connect failed (%d)\n", mqtt.state());
+            return;
+        }
+        mqtt.publish(topicOnline, "1", true);
+        publishedVersion = 0;  // Refresh the retained status right away
+        log.printf("[Net] connected to %s as %s\n", BREW_MQTT_HOST, id);
+    }
+
+    void publishPending(unsigned long now) {
+        // A summary leaves the ring only once the broker took it
+        NetShot shot;
+        while (shots.peek(shot)) {
+            if (!mqtt.publish(topicShot, formatShot(shot))) break;
+            shots.consume();
+        }
+        if (shots.dropped() != shotsDroppedReported) {
+            shotsDroppedReported = shots.dropped();
+            log.printf("[Net] %u shot summaries dropped\n", (unsigned)shotsDroppedReported);
+        }
+
+        if (now - lastPublish < PUBLISH_MS) return;
+        if (status.version() == publishedVersion) return;
+        BrewStatus snap;
+        uint32_t v = status.read(snap);
+        if (mqtt.publish(topicStatus, formatStatus(snap), true)) {
+            publishedVersion = v;
+            lastPublish = now;
+        }
+    }
+
+public:
+    NetBridge(const SeqLock<BrewStatus> &statusIn, Print &logOut)
+        : status(statusIn), log(logOut), mqtt(wifi) {}
+
+#if BREW_OTA
+    // Serve updates from this task once WiFi is up; call before run()
+    void attachOta(OtaUpdate &o) { ota = &o; }
+#endif
+
+    // UI side: never blocks; a full queue loses its oldest summary
+    void queueShot(const NetShot &s) { shots.push(s); }
+
+    // Task body (core 0, below the protocol task)
+    void run() {
+        if (!BREW_NET_SSID[0]) {
+            log.println("[Net] no access point set (include/credentials.h), staying offline");
+            vTaskDelete(nullptr);
+        }
+
+        uint8_t mac[6];
+        WiFi.mode(WIFI_STA);
+        WiFi.macAddress(mac);
+        snprintf(id, sizeof(id), "bf-%02x%02x%02x", mac[3], mac[4], mac[5]);
+        snprintf(topicStatus, sizeof(topicStatus), "brewforge/%s/status", id);
+        snprintf(topicShot, sizeof(topicShot), "brewforge/%s/shot", id);
+        snprintf(topicOnline, sizeof(topicOnline), "brewforge/%s/online", id);
+
+        WiFi.setHostname(id);
+        WiFi.setAutoReconnect(true);
+        WiFi.begin(BREW_NET_SSID, BREW_NET_PASS);
+        mqtt.setServer(BREW_MQTT_HOST, BREW_MQTT_PORT);
+        mqtt.setBufferSize(MAX_PAYLOAD + 64);
+        mqtt.setSocketTimeout(2);
+        log.printf("[Net] joining \"%s\" as %s\n", BREW_NET_SSID, id);
+
+        for (;;) {
+            const unsigned long now = millis();
+            if (WiFi.status() == WL_CONNECTED) {
+#if BREW_OTA
+                if (ota) {
+                    if (!ota->ready()) ota->begin(id);
+                    ota->poll();
+                }
+#endif
+                if (!mqtt.connected()) {
+                    if (wasConnected) log.println("[Net] broker connection lost");
+                    if (lastConnectTry == 0 || now - lastConnectTry > RECONNECT_MS) connect(now);
+                }
+                wasConnected = mqtt.connected();
+                if (wasConnected) {
+                    mqtt.loop();
+                    publishPending(now);
+                }
+            }
+            vTaskDelay(pdMS_TO_TICKS(TICK_MS));
+        }
+    }
+};
+
+#endif  // BREW_NET
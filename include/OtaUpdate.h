@@ -0,0 +1,254 @@
+/**
+ * OtaUpdate.h - Firmware updates over WiFi, and confirming a new image
+ *
+ * OtaUpdate (BREW_OTA=1, needs BREW_NET) answers espota ("pio run -e
+ * esp32dev-ota -t upload --upload-port <id>.local") through ArduinoOTA
+ * from the NetBridge task on core 0. The image streams in chunks straight
+ * into the inactive app partition while the UI on core 1 keeps showing
+ * live data; only the final switch-over reboots. Flash writes pause the
+ * caches of both cores for a few ms per sector, so the UI stutters but
+ * doesn't stop.
+ *
+ * Never while the pump runs: upload invitations go unanswered while
+ * status says the pump is on (espota then reports no response), and an
+ * upload in progress is aborted if the pump comes on.
+ *
+ * progress() is 0-100 during an upload and -1 otherwise; main shows it in
+ * BrewScreen's nav area.
+ *
+ * BootConfirm, in every build: a freshly written image runs on trial and
+ * the previous one comes back if the new one keeps resetting before it is
+ * marked good. main defers that mark (verifyRollbackLater()) until the UI
+ * has run for CONFIRM_AFTER_MS after its first frame, so an image that
+ * crashes during start-up is rolled back by itself.
+ *
+ * Two mechanisms, picked by the SDK's sdkconfig and logged at boot:
+ *  - CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE set: the bootloader boots the
+ *    image pending-verify and falls back after one unconfirmed reset.
+ *  - Otherwise (the prebuilt arduino-esp32 SDK): OtaUpdate arms a trial in
+ *    NVS once an upload is written, each boot of that image counts, and
+ *    the MAX_TRIAL_BOOTS-th unconfirmed one points the boot partition back
+ *    at the previous slot and restarts. A few boots rather than one, so
+ *    pulling the plug during start-up doesn't throw a good image away.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+
+namespace BootConfirm {
+
+static constexpr uint32_t CONFIRM_AFTER_MS = 30000;  // Of running UI, after the first frame
+
+#if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) || defined(CONFIG_APP_ROLLBACK_ENABLE)
+
+inline bool pending() {
+    esp_ota_img_states_t state;
+    return esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) == ESP_OK &&
+           state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+// The bootloader keeps track of the trial itself
+inline void armTrial(Print &) {}
+
+// Boot log: the mechanism, and say so if we are here because an update was rolled back
+inline void begin(Print &log) {
+    log.println("[OTA] rollback: bootloader, pending-verify");
+    const esp_partition_t *bad = esp_ota_get_last_invalid_partition();
+    if (bad) log.printf("[OTA] image in %s failed to boot and was rolled back\n", bad->label);
+    if (pending()) log.println("[OTA] new image, confirming once the UI is up");
+}
+
+inline void confirm(Print &log) {
+    if (!pending()) return;
+    if (esp_ota_mark_app_valid_cancel_rollback() == ESP_OK) log.println("[OTA] new image confirmed");
+}
+
+#else
+
+static constexpr uint8_t MAX_TRIAL_BOOTS = 3;
+static constexpr size_t LABEL_LEN = sizeof(esp_partition_t::label);
+
+// NVS "bootconf": trial = slot on trial, back = slot to fall back to,
+// boots = unconfirmed boots of the trial so far, bad = slot just rolled back
+inline bool pending() {
+    Preferences prefs;
+    if (!prefs.begin("bootconf", true)) return false;
+    char trial[LABEL_LEN] = "";
+    prefs.getString("trial", trial, sizeof(trial));
+    prefs.end();
+    return trial[0] && strcmp(trial, esp_ota_get_running_partition()->label) == 0;
+}
+
+// OtaUpdate, once an upload is written and set to boot: run it on trial
+inline void armTrial(Print &log) {
+    const esp_partition_t *next = esp_ota_get_boot_partition();
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (!next || next == running) return;
+
+    Preferences prefs;
+    if (!prefs.begin("bootconf", false)) {
+        log.println("[OTA] NVS unavailable, new image runs without rollback");
+        return;
+    }
+    prefs.putString("trial", next->label);
+    prefs.putString("back", running->label);
+    prefs.putUChar("boots", 0);
+    prefs.end();
+}
+
+// Boot log: the mechanism, and count this boot if the image is on trial.
+// Doesn't return if the trial ran out and the previous image is restored.
+inline void begin(Print &log) {
+    log.printf("[OTA] rollback: NVS boot counter, %u unconfirmed boots\n", MAX_TRIAL_BOOTS);
+
+    Preferences prefs;
+    if (!prefs.begin("bootconf", false)) return;
+    char trial[LABEL_LEN] = "", back[LABEL_LEN] = "", bad[LABEL_LEN] = "";
+    prefs.getString("trial", trial, sizeof(trial));
+    prefs.getString("back", back, sizeof(back));
+    prefs.getString("bad", bad, sizeof(bad));
+
+    if (bad[0]) {
+        log.printf("[OTA] image in %s failed to boot and was rolled back\n", bad);
+        prefs.remove("bad");
+    }
+    if (!trial[0]) {
+        prefs.end();
+        return;
+    }
+
+    // Flashed over USB since, or the switch never happened: nothing on trial
+    if (strcmp(trial, esp_ota_get_running_partition()->label) != 0) {
+        prefs.remove("trial");
+        prefs.end();
+        return;
+    }
+
+    const uint8_t boots = prefs.getUChar("boots", 0);
+    if (boots < MAX_TRIAL_BOOTS) {
+        prefs.putUChar("boots", boots + 1);
+        prefs.end();
+        log.printf("[OTA] new image, boot %u of %u, confirming once the UI is up\n",
+                   boots + 1, MAX_TRIAL_BOOTS);
+        return;
+    }
+
+    const esp_partition_t *prev =
+        esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, back);
+    prefs.remove("trial");
+    if (!prev || esp_ota_set_boot_partition(prev) != ESP_OK) {
+        prefs.end();
+        log.printf("[OTA] image in %s never confirmed, but %s won't boot either; keeping it\n",
+                   trial, back);
+        return;
+    }
+    prefs.putString("bad", trial);
+    prefs.end();
+    log.printf("[OTA] image in %s not confirmed after %u boots, back to %s\n",
+               trial, MAX_TRIAL_BOOTS, back);
+    log.flush();
+    ESP.restart();
+}
+
+inline void confirm(Print &log) {
+    if (!pending()) return;
+    Preferences prefs;
+    if (!prefs.begin("bootconf", false)) return;
+    prefs.remove("trial");
+    prefs.remove("boots");
+    prefs.end();
+    log.println("[OTA] new image confirmed");
+}
+
+#endif
+
+}  // namespace BootConfirm
+
+#if BREW_OTA
+
+#if !BREW_NET
+#error "BREW_OTA needs BREW_NET"
+#endif
+
+#include <ArduinoOTA.h>
+#include <Update.h>
+#include <atomic>
+
+#include "BrewStatus.h"
+#include "Spsc.h"
+
+// Access point, broker and OTA password; untracked, see credentials.h.example
+#if __has_include("credentials.h")
+#include "credentials.h"
+#endif
+
+#ifndef BREW_OTA_PASS
+#define BREW_OTA_PASS ""
+#endif
+
+class OtaUpdate {
+private:
+    const SeqLock<BrewStatus> &status;
+    Print &log;
+    std::atomic<int8_t> percent{-1};
+    bool started = false;
+
+    bool pumpOn() const {
+        BrewStatus s;
+        status.read(s);
+        return s.pump;
+    }
+
+public:
+    OtaUpdate(const SeqLock<BrewStatus> &statusIn, Print &logOut)
+        : status(statusIn), log(logOut) {}
+
+    // Net task, once WiFi is up
+    void begin(const char *hostname) {
+        ArduinoOTA.setHostname(hostname);
+        if (BREW_OTA_PASS[0]) ArduinoOTA.setPassword(BREW_OTA_PASS);
+        ArduinoOTA.setRebootOnSuccess(true);
+
+        ArduinoOTA.onStart([this]() {
+            percent.store(0, std::memory_order_relaxed);
+            log.println("[OTA] update started");
+        });
+        ArduinoOTA.onProgress([this](unsigned int done, unsigned int total) {
+            if (pumpOn()) {
+                Update.abort();
+                log.println("[OTA] pump came on, update aborted");
+                return;
+            }
+            percent.store(total ? (int8_t)((uint64_t)done * 100 / total) : 0,
+                          std::memory_order_relaxed);
+        });
+        ArduinoOTA.onEnd([this]() {
+            percent.store(100, std::memory_order_relaxed);
+            BootConfirm::armTrial(log);
+            log.println("[OTA] update written, rebooting");
+        });
+        ArduinoOTA.onError([this](ota_error_t err) {
+            percent.store(-1, std::memory_order_relaxed);
+            log.printf("[OTA] update failed (%d)\n", (int)err);
+        });
+
+        ArduinoOTA.begin();
+        started = true;
+        log.printf("[OTA] listening as %s.local\n", hostname);
+    }
+
+    bool ready() const { return started; }
+
+    // Net task, every pass. An accepted upload runs to the end inside this call.
+    void poll() {
+        if (!started || pumpOn()) return;
+        ArduinoOTA.handle();
+    }
+
+    int8_t progress() const { return percent.load(std::memory_order_relaxed); }
+};
+
+#endif  // BREW_OTA
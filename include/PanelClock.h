@@ -0,0 +1,141 @@
+/**
+ * PanelClock.h - Boot-time SPI clock selection for the ST7789
+ *
+ * The panel shares HSPI's native IOMUX pins (SCLK 14, MOSI 13, MISO 12,
+ * CS 15), so the write clock can go well past the 27 MHz the build used
+ * to pin; how far depends on the individual panel and its wiring. At boot,
+ * with the backlight still off, select() writes known patterns into a
+ * block of GRAM at each candidate clock, reads them back over MISO at
+ * SPI_READ_FREQUENCY, and keeps the fastest clock that returns every
+ * pixel intact over several rounds.
+ *
+ * The winner is stored in NVS ("panelclk"). Later boots only re-verify
+ * the stored clock and run the full search again if it fails, so a board
+ * that stops coping (new panel, temperature) falls back by itself. Boards
+ * that fail every candidate stay at SPI_SAFE_FREQUENCY.
+ *
+ * Candidates are what the ESP32 can divide exactly from its 80 MHz APB
+ * clock. The DMA device takes its clock in initDMA(), so run select()
+ * before Compositor::begin().
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <SPI.h>
+#include <TFT_eSPI.h>
+
+#include "SpiClock.h"
+
+namespace PanelClock {
+
+static constexpr uint16_t VERSION = 1;       // Bump to force a re-test everywhere
+static constexpr uint32_t SAFE_HZ = SPI_SAFE_FREQUENCY;
+
+// Fastest first; each must be 80 MHz / n
+static constexpr uint32_t CANDIDATES[] = { 80000000, 40000000 };
+
+static constexpr int16_t TEST_W = 64;       // GRAM block written and read back
+static constexpr int16_t TEST_H = 8;
+static constexpr uint8_t ROUNDS = 3;        // Passes of every pattern per clock
+static constexpr uint8_t PATTERNS = 4;
+
+inline void apply(uint32_t hz) {
+    brewSpiHz = hz;
+    TFT_eSPI::getSPIinstance().setFrequency(hz);  // For builds without transactions
+}
+
+// Pixel i of test pattern p: solid, inverted, checkerboard, pseudo-random
+inline uint16_t patternPixel(uint8_t p, uint16_t i, uint32_t &lfsr) {
+    switch (p) {
+        case 0:  return 0x0000;
+        case 1:  return 0xFFFF;
+        case 2:  return ((i + i / TEST_W) & 1) ? 0xAAAA : 0x5555;
+        default:
+            lfsr = lfsr * 1664525u + 1013904223u;
+            return (uint16_t)(lfsr >> 16);
+    }
+}
+
+// Write and read back every pattern ROUNDS times at `hz`
+inline bool verify(TFT_eSPI &tft, uint32_t hz) {
+    static uint16_t out[TEST_W * TEST_H];  // 2 KB together: keep off the stack
+    static uint16_t in[TEST_W * TEST_H];
+
+    apply(hz);
+    uint32_t lfsr = hz;
+    for (uint8_t round = 0; round < ROUNDS; round++) {
+        for (uint8_t p = 0; p < PATTERNS; p++) {
+            for (uint16_t i = 0; i < TEST_W * TEST_H; i++) out[i] = patternPixel(p, i, lfsr);
+            tft.pushImage(0, 0, TEST_W, TEST_H, out);
+            tft.readRect(0, 0, TEST_W, TEST_H, in);
+            if (memcmp(in, out, sizeof(out)) != 0) return false;
+        }
+    }
+    return true;
+}
+
+inline uint32_t load() {
+    Preferences prefs;
+    if (!prefs.begin("panelclk", true)) return 0;
+    uint32_t hz = prefs.getUShort("ver", 0) == VERSION ? prefs.getULong("hz", 0) : 0;
+    prefs.end();
+    return hz;
+}
+
+inline bool save(uint32_t hz) {
+    Preferences prefs;
+    if (!prefs.begin("panelclk", false)) return false;
+    bool ok = prefs.putULong("hz", hz) == sizeof(uint32_t) &&
+              prefs.putUShort("ver", VERSION) == sizeof(uint16_t);
+    prefs.end();
+    return ok;
+}
+
+// Drop the stored clock; the next boot runs the full search
+inline void forget() {
+    Preferences prefs;
+    if (!prefs.begin("panelclk", false)) return;
+    prefs.clear();
+    prefs.end();
+}
+
+// Average full-screen fill time at the current clock, in microseconds
+inline uint32_t frameMicros(TFT_eSPI &tft, uint8_t frames = 4) {
+    uint32_t t0 = micros();
+    for (uint8_t i = 0; i < frames; i++) tft.fillScreen(i & 1 ? 0xFFFF : 0x0000);
+    tft.fillScreen(0x0000);
+    return (micros() - t0) / (frames + 1);
+}
+
+/**
+ * Pick, apply and remember the write clock. Leaves GRAM black. Logs the
+ * outcome and the resulting full-frame time to `log`.
+ */
+inline uint32_t select(TFT_eSPI &tft, Print &log) {
+    uint32_t hz = 0;
+    const uint32_t stored = load();
+    if (stored == SAFE_HZ || (stored && verify(tft, stored))) {
+        hz = stored;
+    } else {
+        if (stored) log.printf("[Panel] stored %u Hz failed readback, re-testing\n", (unsigned)stored);
+        for (uint32_t c : CANDIDATES) {
+            if (verify(tft, c)) {
+                hz = c;
+                break;
+            }
+            log.printf("[Panel] %u MHz failed readback\n", (unsigned)(c / 1000000));
+        }
+        if (!hz) hz = SAFE_HZ;
+        if (!save(hz)) log.println("[Panel] failed to store SPI clock");
+    }
+
+    apply(hz);
+    log.printf("[Panel] SPI %u.%u MHz, full frame %u us\n",
+               (unsigned)(hz / 1000000), (unsigned)(hz / 100000 % 10),
+               (unsigned)frameMicros(tft));
+    return hz;
+}
+
+}  // namespace PanelClock
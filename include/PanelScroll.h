@@ -0,0 +1,133 @@
+/**
+ * PanelScroll.h - ST7789 hardware scrolling and partial display mode
+ *
+ * ForgeUI's GfxDriver only draws, so scrolling views talk to the panel
+ * through this instead. One PanelScroll owns the panel's scroll state:
+ *
+ *   define(top, rows)  VSCRDEF: rows [top, top + rows) scroll, the rest
+ *                      of the panel stays fixed
+ *   scrollBy(n)        VSCRSADD: move the view n rows in one register
+ *                      write; the n rows that come into view still hold
+ *                      stale pixels and must be redrawn by the caller
+ *   reset()            back to an unscrolled, full-screen area with
+ *                      normal (not partial) scan-out
+ *
+ * While scrolled, screen row top + i shows panel memory row
+ * panelRow(i). Anything drawn into the scroll area must go to the panel
+ * row, not the screen row, which is why LazyScreenManager resets the
+ * scroll whenever the screen changes.
+ *
+ * Partial mode (PTLAR/PTLON) limits scan-out to a band of rows; the
+ * panel shows nothing outside it while driving fewer lines.
+ *
+ * Every call sends commands on the SPI bus, so only use it while no
+ * compositor frame is in flight.
+ *
+ * Scrolling follows panel rows, which are screen rows in the portrait
+ * rotation (0) this UI uses.
+ */
+
+#pragma once
+
+#include <TFT_eSPI.h>
+
+class PanelScroll {
+private:
+    // ST7789 commands
+    static constexpr uint8_t ST_PTLON    = 0x12;
+    static constexpr uint8_t ST_NORON    = 0x13;
+    static constexpr uint8_t ST_PTLAR    = 0x30;
+    static constexpr uint8_t ST_VSCRDEF  = 0x33;
+    static constexpr uint8_t ST_VSCRSADD = 0x37;
+
+    TFT_eSPI &tft;
+    int16_t   panelH;
+    int16_t   top = 0;
+    int16_t   rows = 0;      // 0: no scroll area defined
+    int16_t   offset = 0;
+    bool      partial = false;
+
+    void write16(uint16_t v) {
+        tft.writedata(v >> 8);
+        tft.writedata(v & 0xFF);
+    }
+
+    void writeStart() {
+        tft.writecommand(ST_VSCRSADD);
+        write16(top + offset);
+    }
+
+public:
+    explicit PanelScroll(TFT_eSPI &display, int16_t panelHeight = 320)
+        : tft(display), panelH(panelHeight) {}
+
+    // Scroll rows [areaTop, areaTop + areaRows); everything else stays put
+    void define(int16_t areaTop, int16_t areaRows) {
+        top = areaTop;
+        rows = areaRows;
+        offset = 0;
+        tft.writecommand(ST_VSCRDEF);
+        write16(top);
+        write16(rows);
+        write16(panelH - top - rows);
+        writeStart();
+    }
+
+    void reset() {
+        clearPartial();
+        if (rows == 0 && offset == 0) return;
+        define(0, panelH);
+        rows = 0;
+    }
+
+    bool active() const { return rows > 0; }
+    int16_t areaTop() const { return top; }
+    int16_t areaRows() const { return rows; }
+    int16_t scrollOffset() const { return offset; }
+
+    // Panel memory row shown at screen row areaTop() + i
+    int16_t panelRow(int16_t i) const {
+        return rows ? top + (offset + i) % rows : i;
+    }
+
+    // Panel row for any screen row; identity outside the scroll area
+    int16_t toPanel(int16_t screenY) const {
+        if (!rows || screenY < top || screenY >= top + rows) return screenY;
+        return panelRow(screenY - top);
+    }
+
+    /**
+     * Move the content up by n rows (down for negative n). The rows that
+     * scroll in at the bottom (top) are panelRow(rows - n) .. panelRow(rows - 1)
+     * (panelRow(0) .. panelRow(-n - 1)) afterwards, and hold stale pixels.
+     */
+    void scrollBy(int16_t n) {
+        if (!rows) return;
+        offset = (int16_t)(((offset + n) % rows + rows) % rows);
+        writeStart();
+    }
+
+    // Jump straight to an offset, e.g. 0 before repainting the whole area
+    void scrollTo(int16_t newOffset) {
+        if (!rows) return;
+        offset = (int16_t)((newOffset % rows + rows) % rows);
+        writeStart();
+    }
+
+    // Scan out only rows [y0, y1]; the rest of the panel goes blank
+    void setPartial(int16_t y0, int16_t y1) {
+        tft.writecommand(ST_PTLAR);
+        write16(y0);
+        write16(y1);
+        tft.writecommand(ST_PTLON);
+        partial = true;
+    }
+
+    void clearPartial() {
+        if (!partial) return;
+        tft.writecommand(ST_NORON);
+        partial = false;
+    }
+
+    bool isPartial() const { return partial; }
+};
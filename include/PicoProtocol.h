@@ -0,0 +1,224 @@
+/**
+ * PicoProtocol.h - Wire protocol for the Pico <-> HMI link
+ *
+ * The Pico speaks JSON lines by default. After the HMI sends
+ * FORMAT_BINARY it may switch to compact binary frames; both kinds can be
+ * mixed on the wire and the HMI detects them per frame.
+ *
+ * Frame layout:
+ *   SYNC(0xA5) | type | len | payload[len] | crc16 (little-endian)
+ *
+ * The CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over
+ * type, len and payload. A 0xA5 never occurs in a JSON line, so the
+ * receiver can resync on it at any point.
+ *
+ * Status delivery is push-based: the HMI sends SUBSCRIBE followed by the
+ * stream period in ms ("S200"). The Pico then sends a frame every period
+ * and immediately on every state transition. A subscription lapses if it
+ * is not renewed within LINK_TIMEOUT_MS, and the HMI treats the same
+ * silence from the Pico as a lost link — the stream is the keepalive in
+ * both directions.
+ *
+ * FRAME_STATUS carries a full StatusPayload (~31 bytes on the wire vs
+ * ~250 for JSON). FRAME_DELTA carries a uint16 field mask followed by only
+ * the fields whose bit is set, in Field order, each in its
+ * StatusPayload encoding.
+ *
+ * Commands (HMI -> Pico) are tagged lines, "C<seq>:<op>[arg]":
+ *   C17:b     start the program        C18:x     stop
+ *   C19:T+25  target +25 C              C20:T-5   target -5 C
+ * The Pico acks each one after acting on it, with FRAME_ACK (payload:
+ * uint16 seq) in binary mode or {"ack":19} in JSON mode. The HMI keeps one
+ * command in flight and resends it with the same seq until acked, so the
+ * Pico must remember the last seq it executed and only re-ack a repeat.
+ * seq runs 1..65535 and wraps past 0. Firmware that predates tags ignores
+ * these lines; see CommandChannel.h for the fallback to bare op chars.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "BrewStatus.h"
+
+namespace PicoProto {
+
+static constexpr uint8_t SYNC = 0xA5;
+
+enum FrameType : uint8_t {
+    FRAME_STATUS = 0x01,
+    FRAME_DELTA  = 0x02,
+    FRAME_ACK    = 0x03,
+};
+
+// Line commands (HMI -> Pico), sent followed by '\n'
+static constexpr const char *FORMAT_BINARY = "F1";
+static constexpr const char *FORMAT_JSON   = "F0";
+static constexpr char        SUBSCRIBE     = 'S';  // + period in ms
+static constexpr char        CMD_TAG       = 'C';  // + seq ':' op [arg]
+
+// Command ops; the op char alone is also the legacy untagged command
+enum CmdOp : char {
+    OP_BREW   = 'b',
+    OP_STOP   = 'x',
+    OP_TARGET = 'T',  // arg: signed whole degrees C
+};
+
+// Silence on either side longer than this drops the link / subscription
+static constexpr uint32_t LINK_TIMEOUT_MS = 3000;
+
+// Relay bits in StatusPayload::relays
+enum : uint8_t {
+    RELAY_PUMP     = 1 << 0,
+    RELAY_BOILER   = 1 << 1,
+    RELAY_SOLENOID = 1 << 2,
+    RELAY_WARMER   = 1 << 3,
+};
+
+// Field order / delta mask bits
+enum Field : uint8_t {
+    F_TEMP, F_TEMPF, F_TARGET, F_FLOW, F_VOLUME, F_TEMPRATE,
+    F_STEP, F_STEP_ELAPSED, F_STEP_TIME, F_RELAYS, F_STATE,
+    F_COUNT
+};
+
+static constexpr size_t STATE_LEN = 8;
+
+// Temperatures, flow and volume in tenths; tempRate in hundredths per second
+struct __attribute__((packed)) StatusPayload {
+    int16_t  temp;
+    int16_t  tempF;
+    int16_t  target;
+    int16_t  flow;
+    int16_t  volume;
+    int16_t  tempRate;
+    uint8_t  step;
+    uint16_t stepElapsed;
+    uint16_t stepTime;
+    uint8_t  relays;
+    char     state[STATE_LEN];  // Not NUL-terminated when full
+};
+
+static_assert(sizeof(StatusPayload) == 26, "StatusPayload layout changed");
+
+static constexpr uint8_t FIELD_SIZE[F_COUNT] = {
+    2, 2, 2, 2, 2, 2, 1, 2, 2, 1, STATE_LEN
+};
+
+static constexpr size_t FIELD_OFFSET[F_COUNT] = {
+    offsetof(StatusPayload, temp),
+    offsetof(StatusPayload, tempF),
+    offsetof(StatusPayload, target),
+    offsetof(StatusPayload, flow),
+    offsetof(StatusPayload, volume),
+    offsetof(StatusPayload, tempRate),
+    offsetof(StatusPayload, step),
+    offsetof(StatusPayload, stepElapsed),
+    offsetof(StatusPayload, stepTime),
+    offsetof(StatusPayload, relays),
+    offsetof(StatusPayload, state),
+};
+
+// Largest frame after SYNC: type + len + payload + crc
+static constexpr size_t MAX_FRAME_LEN = 2 + 255 + 2;
+
+inline uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+inline int16_t rd16(const uint8_t *p) { return (int16_t)(p[0] | (p[1] << 8)); }
+
+// Write one payload field into BrewStatus, flagging what changed
+inline void applyField(uint8_t field, const uint8_t *p, BrewStatus &out) {
+    switch (field) {
+        case F_TEMP:         out.set(out.temp,     rd16(p), BF_TEMP);     break;
+        case F_TEMPF:        out.set(out.tempF,    rd16(p), BF_TEMPF);    break;
+        case F_TARGET:       out.set(out.target,   rd16(p), BF_TARGET);   break;
+        case F_FLOW:         out.set(out.flow,     rd16(p), BF_FLOW);     break;
+        case F_VOLUME:       out.set(out.volume,   rd16(p), BF_VOLUME);   break;
+        case F_TEMPRATE:     out.set(out.tempRate, rd16(p), BF_TEMPRATE); break;
+        case F_STEP:         out.set(out.step,        (int)p[0],               BF_STEP);         break;
+        case F_STEP_ELAPSED: out.set(out.stepElapsed, (int)(uint16_t)rd16(p),  BF_STEP_ELAPSED); break;
+        case F_STEP_TIME:    out.set(out.stepTime,    (int)(uint16_t)rd16(p),  BF_STEP_TIME);    break;
+        case F_RELAYS:
+            out.set(out.pump,     (p[0] & RELAY_PUMP) != 0,     BF_PUMP);
+            out.set(out.boiler,   (p[0] & RELAY_BOILER) != 0,   BF_BOILER);
+            out.set(out.solenoid, (p[0] & RELAY_SOLENOID) != 0, BF_SOLENOID);
+            out.set(out.warmer,   (p[0] & RELAY_WARMER) != 0,   BF_WARMER);
+            break;
+        case F_STATE: {
+            size_t n = 0;
+            while (n < STATE_LEN && p[n]) n++;
+            out.setState((const char *)p, n);
+            break;
+        }
+    }
+}
+
+// Length and CRC check of one frame as stored by the receiver
+inline bool checkFrame(const uint8_t *frame, size_t len) {
+    if (len < 4) return false;
+    uint8_t plen = frame[1];
+    if (len != (size_t)plen + 4) return false;
+
+    uint16_t crc = frame[2 + plen] | (frame[3 + plen] << 8);
+    return crc16(frame, 2 + plen) == crc;
+}
+
+// A valid FRAME_ACK: its seq goes to `seq`. False for any other frame.
+inline bool decodeAck(const uint8_t *frame, size_t len, uint16_t &seq) {
+    if (len < 4 || frame[0] != FRAME_ACK || frame[1] != 2) return false;
+    if (!checkFrame(frame, len)) return false;
+    seq = (uint16_t)rd16(frame + 2);
+    return true;
+}
+
+/**
+ * Decode one status frame as stored by the receiver (everything after SYNC).
+ * Returns false on a bad CRC, length or type; `out` is untouched then.
+ */
+inline bool decode(const uint8_t *frame, size_t len, BrewStatus &out) {
+    if (!checkFrame(frame, len)) return false;
+    uint8_t type = frame[0];
+    uint8_t plen = frame[1];
+
+    const uint8_t *p = frame + 2;
+
+    if (type == FRAME_STATUS) {
+        if (plen != sizeof(StatusPayload)) return false;
+        for (uint8_t f = 0; f < F_COUNT; f++)
+            applyField(f, p + FIELD_OFFSET[f], out);
+        return true;
+    }
+
+    if (type == FRAME_DELTA) {
+        if (plen < 2) return false;
+        uint16_t mask = (uint16_t)rd16(p);
+
+        // Size check first so a short frame applies nothing
+        size_t need = 2;
+        for (uint8_t f = 0; f < F_COUNT; f++)
+            if (mask & (1u << f)) need += FIELD_SIZE[f];
+        if (need != plen) return false;
+
+        p += 2;
+        for (uint8_t f = 0; f < F_COUNT; f++) {
+            if (!(mask & (1u << f))) continue;
+            applyField(f, p, out);
+            p += FIELD_SIZE[f];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+}  // namespace PicoProto
@@ -0,0 +1,157 @@
+/**
+ * Profiler.h - Always-on timing histograms for the HMI pipeline
+ *
+ * Each Metric owns a fixed-size log-scale histogram (4 sub-buckets per
+ * power of two, so about 19% resolution from 1 ns to 4 s) of nanoseconds.
+ * Nothing allocates and recording is a handful of instructions, so the
+ * hooks stay compiled in.
+ *
+ * Section timings (PROF_SCOPE) use the CPU cycle counter. It is per core,
+ * which is fine because a scope begins and ends on the same core.
+ * End-to-end latencies cross cores (UART event task -> protocol task ->
+ * loop), so they are taken with esp_timer, which every core shares, at
+ * microsecond resolution.
+ *
+ * Every histogram has a single writer: UART and PARSE on the protocol core,
+ * the rest on the loop core. Readers (overlay, CSV dump) may see a count
+ * mid-update, which is harmless for statistics.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+namespace Prof {
+
+enum Metric : uint8_t {
+    UART,        // updateUART() pass (core 0)
+    PARSE,       // One status frame, JSON or binary (core 0)
+    TOUCH,       // handleTouch()
+    UPDATE,      // screenMgr.update()
+    DRAW,        // screenMgr.draw()
+    LAT_PIXEL,   // UART bytes in -> changed pixels on the panel
+    LAT_CMD,     // Touch dispatched -> sendCmd()
+    METRIC_COUNT
+};
+
+static constexpr const char *NAMES[METRIC_COUNT] = {
+    "uart", "parse", "touch", "update", "draw", "rx>px", "tap>cmd"
+};
+
+class Histogram {
+public:
+    static constexpr uint8_t BUCKETS = 124;
+
+private:
+    uint32_t counts[BUCKETS] = {};
+    uint32_t total = 0;
+    uint32_t maxNs = 0;
+
+    static uint8_t bucketOf(uint32_t v) {
+        if (v < 4) return v;
+        uint8_t msb = 31 - __builtin_clz(v);
+        return (msb - 1) * 4 + ((v >> (msb - 2)) & 3);
+    }
+
+public:
+    // Smallest value that lands in bucket i
+    static uint32_t bucketFloor(uint8_t i) {
+        if (i < 4) return i;
+        uint8_t msb = i / 4 + 1;
+        return (uint32_t)(4 + i % 4) << (msb - 2);
+    }
+
+    void record(uint32_t ns) {
+        counts[bucketOf(ns)]++;
+        total++;
+        if (ns > maxNs) maxNs = ns;
+    }
+
+    uint32_t count() const { return total; }
+    uint32_t max() const { return maxNs; }
+    uint32_t bucket(uint8_t i) const { return counts[i]; }
+
+    // Approximate percentile (0-100) in ns: midpoint of the bucket holding it
+    uint32_t percentile(uint8_t pct) const {
+        if (!total) return 0;
+        uint32_t rank = (uint32_t)(((uint64_t)total * pct + 99) / 100);
+        if (rank == 0) rank = 1;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint32_t lo = bucketFloor(i);
+                uint32_t hi = (i + 1 < BUCKETS) ? bucketFloor(i + 1) : lo;
+                uint32_t mid = lo + (hi - lo) / 2;
+                return mid < maxNs ? mid : maxNs;
+            }
+        }
+        return maxNs;
+    }
+
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        maxNs = 0;
+    }
+};
+
+inline Histogram hist[METRIC_COUNT];
+
+inline uint32_t cycles() { return ESP.getCycleCount(); }
+inline uint32_t micros32() { return (uint32_t)esp_timer_get_time(); }
+
+inline uint32_t cyclesToNs(uint32_t c) {
+    return (uint32_t)((uint64_t)c * 1000 / getCpuFrequencyMhz());
+}
+
+inline void recordCycles(Metric m, uint32_t c) { hist[m].record(cyclesToNs(c)); }
+
+// Latency between two micros32() stamps
+inline void recordSpan(Metric m, uint32_t startUs, uint32_t endUs) {
+    uint32_t us = endUs - startUs;
+    hist[m].record(us > UINT32_MAX / 1000 ? UINT32_MAX : us * 1000);
+}
+
+// Times the enclosing block
+class Scope {
+    Metric   m;
+    uint32_t t0;
+public:
+    explicit Scope(Metric metric) : m(metric), t0(cycles()) {}
+    ~Scope() { recordCycles(m, cycles() - t0); }
+};
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROF_SCOPE(metric) Prof::Scope PROF_CAT(profScope_, __LINE__)(Prof::metric)
+
+inline void resetAll() {
+    for (auto &h : hist) h.reset();
+}
+
+/**
+ * Dump every histogram as CSV: one summary row per metric, then every
+ * non-empty bucket (lower bound in ns) for plotting.
+ */
+inline void dumpCsv(Print &out) {
+    out.println("metric,count,p50_us,p90_us,p99_us,max_us");
+    for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+        const Histogram &h = hist[m];
+        out.printf("%s,%u,%.2f,%.2f,%.2f,%.2f\n", NAMES[m], (unsigned)h.count(),
+                   h.percentile(50) / 1000.0, h.percentile(90) / 1000.0,
+                   h.percentile(99) / 1000.0, h.max() / 1000.0);
+    }
+    out.println("metric,bucket_ns,count");
+    for (uint8_t m = 0; m < METRIC_COUNT; m++) {
+        for (uint8_t i = 0; i < Histogram::BUCKETS; i++) {
+            if (hist[m].bucket(i)) {
+                out.printf("%s,%u,%u\n", NAMES[m], (unsigned)Histogram::bucketFloor(i),
+                           (unsigned)hist[m].bucket(i));
+            }
+        }
+    }
+}
+
+}  // namespace Prof
@@ -0,0 +1,80 @@
+/**
+ * ShotCapture.h - Synthetic Pico traffic for the hot-path benchmarks
+ *
+ * A made-up shot, FRAMES_PER_SHOT status frames long and repeating:
+ * preheat ramp, brew with flow and volume, done. frame(i) gives the
+ * machine state for frame i; encodeJson() and encodeBinary() put it on
+ * the wire exactly as the Pico would, so a replay exercises the same
+ * framing and decoding as live traffic.
+ *
+ * Shared by the on-device benchmark (Bench.h) and the host one
+ * (test/test_bench), so their numbers come from the same input.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "FixedFmt.h"
+#include "PicoProtocol.h"
+
+namespace ShotCapture {
+
+static constexpr uint16_t FRAMES_PER_SHOT = 400;
+
+// Machine state for frame i of a shot: preheat, ramp to target, brew, done
+inline void frame(uint16_t i, PicoProto::StatusPayload &s) {
+    memset(&s, 0, sizeof(s));
+    uint16_t phase = i % FRAMES_PER_SHOT;
+    s.target = 930;
+    s.temp = phase < 150 ? 200 + phase * 5 : 925 + (phase % 7) - 3;
+    s.tempF = s.temp * 9 / 5 + 320;
+    s.tempRate = phase < 150 ? 50 : (phase % 5) - 2;
+    s.step = phase < 150 ? 1 : phase < 350 ? 3 : 7;
+    s.stepElapsed = (phase / 5) % 60;
+    s.stepTime = s.step == 3 ? 30 : 0;
+    s.flow = (s.step == 3) ? 15 + (phase % 11) : 0;
+    s.volume = (s.step == 3) ? (phase - 150) * 2 : 0;
+    s.relays = (s.step == 3 ? PicoProto::RELAY_PUMP | PicoProto::RELAY_SOLENOID : 0) |
+               (s.temp < s.target ? PicoProto::RELAY_BOILER : 0);
+    const char *state = s.step == 1 ? "PREHEAT" : s.step == 3 ? "BREW" : "DONE";
+    strncpy(s.state, state, sizeof(s.state));
+}
+
+// As the Pico's JSON line, '\n' included
+inline size_t encodeJson(const PicoProto::StatusPayload &s, char *buf, size_t size) {
+    char state[PicoProto::STATE_LEN + 1] = {};
+    memcpy(state, s.state, PicoProto::STATE_LEN);
+
+    FixedFmt::TextBuf out(buf, size);
+    out.put("{\"temp\":").fixed(s.temp, 1)
+       .put(",\"tempF\":").fixed(s.tempF, 1)
+       .put(",\"target\":").fixed(s.target, 1)
+       .put(",\"state\":\"").put(state).put('"')
+       .put(",\"step\":").integer(s.step)
+       .put(",\"stepElapsed\":").integer(s.stepElapsed)
+       .put(",\"stepTime\":").integer(s.stepTime)
+       .put(",\"pump\":").put(s.relays & PicoProto::RELAY_PUMP ? "true" : "false")
+       .put(",\"boiler\":").put(s.relays & PicoProto::RELAY_BOILER ? "true" : "false")
+       .put(",\"solenoid\":").put(s.relays & PicoProto::RELAY_SOLENOID ? "true" : "false")
+       .put(",\"warmer\":").put(s.relays & PicoProto::RELAY_WARMER ? "true" : "false")
+       .put(",\"flow\":").fixed(s.flow, 1)
+       .put(",\"volume\":").fixed(s.volume, 1)
+       .put(",\"tempRate\":").fixed(s.tempRate, 2)
+       .put("}\n");
+    return strlen(buf);
+}
+
+// As a FRAME_STATUS binary frame, SYNC included
+inline size_t encodeBinary(const PicoProto::StatusPayload &s, uint8_t *buf) {
+    buf[0] = PicoProto::SYNC;
+    buf[1] = PicoProto::FRAME_STATUS;
+    buf[2] = sizeof(s);
+    memcpy(buf + 3, &s, sizeof(s));
+    uint16_t crc = PicoProto::crc16(buf + 1, 2 + sizeof(s));
+    buf[3 + sizeof(s)] = crc & 0xFF;
+    buf[4 + sizeof(s)] = crc >> 8;
+    return 5 + sizeof(s);
+}
+
+}  // namespace ShotCapture
@@ -0,0 +1,225 @@
+/**
+ * ShotLog.h - Finished shots kept on LittleFS in fixed-size records
+ *
+ * /shots/ holds a small index and one file per slot:
+ *
+ *   index.bin   magic, version, record size, slot count, shots written, crc
+ *   NNN.bin     one Record: shot number, length, target, sample period and
+ *               up to MAX_SAMPLES telemetry samples, crc
+ *
+ * Shot n (counting from 0 since the log was created) lives in slot
+ * n % SLOTS, so read(n) opens one file; nothing is scanned. Once all SLOTS
+ * are used the oldest shot's file is replaced.
+ *
+ * Every file is only ever written whole. LittleFS files are copy-on-write,
+ * so writing into the middle of one copies everything after that point on
+ * close; a whole-file write costs just its own blocks, and commits
+ * atomically on close. A record is written before the index that counts
+ * it, so a reset mid-write leaves the previous shots intact, and every
+ * record carries its own CRC.
+ *
+ * The UI copies a finished shot out of the GraphScreen history with
+ * stage(); the writer task (main.cpp, core 0) then writes it with
+ * flush(): one ~2 KB record file and the index per shot. The render loop
+ * never touches flash. Each block erased still pauses the caches of both
+ * cores for tens of ms, which a couple of blocks per shot keeps rare.
+ *
+ * Shots longer than MAX_SAMPLES raw samples are stored from the first
+ * history level that holds the whole shot, one min/max midpoint per
+ * entry; sampleMs says how far apart the stored samples are.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <rom/crc.h>
+#include <stddef.h>
+#include <atomic>
+
+#include "TimeSeries.h"
+
+class ShotLog {
+public:
+    static constexpr uint16_t VERSION     = 2;       // Bump if the layout changes
+    static constexpr uint32_t MAGIC       = 0x4C534642;  // "BFSL"
+    static constexpr uint16_t MAX_SAMPLES = 256;
+    static constexpr uint16_t SLOTS       = 200;     // ~800 KB of the partition, a block each
+
+    struct __attribute__((packed)) Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint16_t slots;
+        uint16_t reserved;
+        uint32_t written;     // Shots ever appended
+        uint32_t crc;
+    };
+
+    struct __attribute__((packed)) Record {
+        uint32_t shot;        // Shot number
+        uint32_t endedMs;     // Uptime when the shot finished (no RTC)
+        uint16_t durationS;
+        uint16_t sampleMs;    // Time between stored samples
+        uint16_t count;       // Valid entries in samples[]
+        int16_t  target;      // 0.1 C
+        TelemetrySample samples[MAX_SAMPLES];
+        uint32_t crc;
+    };
+
+private:
+    static constexpr const char *DIR      = "/shots";
+    static constexpr const char *INDEX    = "/shots/index.bin";
+    static constexpr const char *OLD_PATH = "/shots.bin";  // Version 1, one file
+
+    Record staged;
+    std::atomic<bool>     stagedFull{false};
+    std::atomic<bool>     mounted{false};
+    std::atomic<uint32_t> written{0};
+
+    template <typename T>
+    static uint32_t crcOf(const T &v) {
+        return crc32_le(0, reinterpret_cast<const uint8_t *>(&v), offsetof(T, crc));
+    }
+
+    // "/shots/017.bin"
+    static void slotPath(uint32_t shot, char (&path)[20]) {
+        snprintf(path, sizeof(path), "%s/%03u.bin", DIR, (unsigned)(shot % SLOTS));
+    }
+
+    static int16_t mid(int16_t lo, int16_t hi) { return (int16_t)((lo + hi) / 2); }
+
+    // Whole file, replacing what was there
+    static bool writeFile(const char *path, const void *data, size_t len) {
+        File f = LittleFS.open(path, "w");
+        bool ok = f && f.write((const uint8_t *)data, len) == len;
+        if (f) f.close();
+        return ok;
+    }
+
+    static bool writeIndex(uint32_t count) {
+        Header h = { MAGIC, VERSION, (uint16_t)sizeof(Record), SLOTS, 0, count, 0 };
+        h.crc = crcOf(h);
+        return writeFile(INDEX, &h, sizeof(h));
+    }
+
+    // Fresh, empty log. Slot files left from before are never read: each
+    // is rewritten before the index counts its shot again.
+    static bool create(Print &log) {
+        LittleFS.remove(OLD_PATH);
+        bool ok = (LittleFS.exists(DIR) || LittleFS.mkdir(DIR)) && writeIndex(0);
+        if (!ok) log.println("[ShotLog] failed to create log");
+        return ok;
+    }
+
+public:
+    /**
+     * Mount LittleFS (formatting it if it has never been) and open the log.
+     * Writer task only; formatting a new partition takes a few seconds.
+     */
+    bool mount(Print &log) {
+        if (!LittleFS.begin(true)) {
+            log.println("[ShotLog] LittleFS mount failed");
+            return false;
+        }
+
+        Header h = {};
+        File f = LittleFS.open(INDEX, "r");
+        bool ok = f && f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+                  h.magic == MAGIC && h.version == VERSION &&
+                  h.recordSize == sizeof(Record) && h.slots == SLOTS &&
+                  h.crc == crcOf(h);
+        if (f) f.close();
+
+        if (!ok) {
+            if (LittleFS.exists(INDEX) || LittleFS.exists(OLD_PATH)) {
+                log.println("[ShotLog] log unreadable or old format, starting a new one");
+            }
+            if (!create(log)) return false;
+            h.written = 0;
+        }
+
+        written.store(h.written, std::memory_order_release);
+        mounted.store(true, std::memory_order_release);
+        log.printf("[ShotLog] %u shots logged\n", (unsigned)h.written);
+        return true;
+    }
+
+    /**
+     * UI side: copy the shot just finished out of `history`. Returns false
+     * if the log isn't mounted or the previous shot is still being written.
+     */
+    template <uint16_t N, uint8_t LEVELS>
+    bool stage(const TimeSeries<N, LEVELS> &history, uint16_t historySampleMs,
+               int16_t target, uint32_t now) {
+        static_assert(N <= MAX_SAMPLES, "history longer than a record");
+        if (!mounted.load(std::memory_order_acquire)) return false;
+        if (stagedFull.load(std::memory_order_acquire)) return false;
+        if (history.total(0) == 0) return false;
+
+        // Coarsest level needed to hold the whole shot
+        uint8_t level = 0;
+        while (level + 1 < LEVELS && history.total(level) > history.size(level)) level++;
+
+        const uint16_t n = history.size(level);
+        for (uint16_t i = 0; i < n; i++) {
+            const TelemetrySpan e = history.at(level, i);
+            staged.samples[i] = { mid(e.lo.temp, e.hi.temp), mid(e.lo.flow, e.hi.flow),
+                                  mid(e.lo.volume, e.hi.volume),
+                                  mid(e.lo.tempRate, e.hi.tempRate) };
+        }
+        memset(staged.samples + n, 0, (MAX_SAMPLES - n) * sizeof(TelemetrySample));
+
+        staged.endedMs = now;
+        staged.durationS = (uint16_t)(history.total(0) * historySampleMs / 1000);
+        staged.sampleMs = (uint16_t)(historySampleMs * TimeSeries<N, LEVELS>::span(level));
+        staged.count = n;
+        staged.target = target;
+        stagedFull.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Writer task: append the staged shot, if any. Returns true if one was written.
+    bool flush(Print &log) {
+        if (!stagedFull.load(std::memory_order_acquire)) return false;
+
+        const uint32_t shot = written.load(std::memory_order_relaxed);
+        staged.shot = shot;
+        staged.crc = crcOf(staged);
+
+        char path[20];
+        slotPath(shot, path);
+        // Record committed (on close) before the index counts it
+        const bool ok = writeFile(path, &staged, sizeof(staged)) && writeIndex(shot + 1);
+
+        if (ok) {
+            written.store(shot + 1, std::memory_order_release);
+            log.printf("[ShotLog] shot %u saved (%u s, %u samples)\n",
+                       (unsigned)shot, (unsigned)staged.durationS, (unsigned)staged.count);
+        } else {
+            log.printf("[ShotLog] failed to write shot %u\n", (unsigned)shot);
+        }
+        stagedFull.store(false, std::memory_order_release);
+        return ok;
+    }
+
+    bool ready() const { return mounted.load(std::memory_order_acquire); }
+
+    // Shots ever written; the log holds [first(), count())
+    uint32_t count() const { return written.load(std::memory_order_acquire); }
+    uint32_t first() const {
+        uint32_t n = count();
+        return n > SLOTS ? n - SLOTS : 0;
+    }
+
+    // Read shot `shot` straight from its slot. False if gone, not yet written or corrupt.
+    bool read(uint32_t shot, Record &out) const {
+        if (!ready() || shot < first() || shot >= count()) return false;
+        char path[20];
+        slotPath(shot, path);
+        File f = LittleFS.open(path, "r");
+        bool ok = f && f.read((uint8_t *)&out, sizeof(out)) == sizeof(out);
+        if (f) f.close();
+        return ok && out.shot == shot && out.crc == crcOf(out) && out.count <= MAX_SAMPLES;
+    }
+};
@@ -0,0 +1,94 @@
+/**
+ * SmallFn.h - Fixed-capacity callable with no heap fallback
+ *
+ * A std::function replacement for UI callbacks. The callable is stored
+ * inline in CAP bytes; anything larger (or over-aligned) is a compile
+ * error rather than a silent heap allocation, so assigning a callback
+ * never touches the allocator.
+ *
+ *   SmallFn<void()> cb = [this]() { onBrew(); };   // 4 bytes of capture
+ *   if (cb) cb();
+ *
+ * The default capacity holds a few pointers, which is all the HMI's
+ * lambdas ever capture.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Sig, size_t CAP = 16>
+class SmallFn;
+
+template <typename R, typename... Args, size_t CAP>
+class SmallFn<R(Args...), CAP> {
+private:
+    struct Ops {
+        R    (*call)(void *obj, Args &&...args);
+        void (*copy)(void *dst, const void *src);
+        void (*destroy)(void *obj);
+    };
+
+    template <typename F>
+    static constexpr Ops opsFor = {
+        [](void *obj, Args &&...args) -> R {
+            return (*static_cast<F *>(obj))(std::forward<Args>(args)...);
+        },
+        [](void *dst, const void *src) { new (dst) F(*static_cast<const F *>(src)); },
+        [](void *obj) { static_cast<F *>(obj)->~F(); },
+    };
+
+    alignas(max_align_t) unsigned char storage[CAP];
+    const Ops *ops = nullptr;
+
+    void assign(const SmallFn &other) {
+        if (other.ops) other.ops->copy(storage, other.storage);
+        ops = other.ops;
+    }
+
+public:
+    SmallFn() = default;
+    SmallFn(std::nullptr_t) {}
+
+    template <typename F,
+              typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<D, SmallFn>::value>>
+    SmallFn(F &&f) {
+        static_assert(sizeof(D) <= CAP, "callable too large for SmallFn; raise CAP");
+        static_assert(alignof(D) <= alignof(max_align_t), "callable over-aligned for SmallFn");
+        new (storage) D(std::forward<F>(f));
+        ops = &opsFor<D>;
+    }
+
+    SmallFn(const SmallFn &other) { assign(other); }
+
+    SmallFn &operator=(const SmallFn &other) {
+        if (this != &other) {
+            reset();
+            assign(other);
+        }
+        return *this;
+    }
+
+    SmallFn &operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    ~SmallFn() { reset(); }
+
+    void reset() {
+        if (ops) ops->destroy(storage);
+        ops = nullptr;
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    R operator()(Args... args) const {
+        // Callables are invoked through a mutable copy, like std::function
+        return ops->call(const_cast<unsigned char *>(storage), std::forward<Args>(args)...);
+    }
+};
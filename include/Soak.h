@@ -0,0 +1,136 @@
+/**
+ * Soak.h - Hooks for the hardware-in-the-loop soak test (tools/hil_soak)
+ *
+ * Built only in the esp32dev-soak environment (BREW_SOAK=1). The host
+ * script stands in for the Pico on Serial2 and drives the USB console:
+ *
+ *   T<x>,<y>[,<holdMs>]\n   inject a tap at screen (x, y), held holdMs
+ *                           (default TAP_MS)
+ *
+ * Injected taps go through the same path as the panel's: handleTouch()
+ * takes them after the XPT2046's own events, in screen coordinates, so
+ * they skip mapTouch() and nothing else. A hold past
+ * TouchInput::LONG_PRESS_MS produces LONG_PRESS and REPEAT events, so
+ * hold-to-ramp on the temp buttons is exercised as well.
+ *
+ * Every REPORT_MS main prints one "[SOAK] key=value ..." line (Sample):
+ * heap free / low-water / largest free block, stack high-water marks,
+ * frames applied and lost, worst status age since the last report (the
+ * stale-screen symptom) and rx -> pixel latency. The script logs those
+ * to CSV over a 24 h run and flags trends.
+ */
+
+#pragma once
+
+#if BREW_SOAK
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+#include "Spsc.h"
+#include "TouchInput.h"
+
+#ifndef BREW_SOAK_REPORT_MS
+#define BREW_SOAK_REPORT_MS 10000
+#endif
+
+namespace Soak {
+
+static constexpr uint32_t REPORT_MS = BREW_SOAK_REPORT_MS;
+static constexpr uint16_t TAP_MS    = 80;
+static constexpr uint16_t MAX_HOLD_MS = 10000;
+
+// ---- Touch injection ----
+
+struct Tap {
+    int16_t  x = 0, y = 0;
+    uint32_t pressedAt = 0;
+    uint32_t releaseAt = 0;
+    uint32_t lastRepeat = 0;
+    bool     active = false;
+    bool     longFired = false;
+};
+
+inline SpscQueue<TouchEvent, 16> injected;
+inline Tap tap;
+inline uint32_t tapsInjected = 0;
+
+inline void queue(TouchEventType type, uint32_t now) {
+    injected.push({ type, tap.x, tap.y, now });
+}
+
+// A tap still held is released first
+inline void inject(int16_t x, int16_t y, uint16_t holdMs, uint32_t now) {
+    if (tap.active) queue(TouchEventType::RELEASE, now);
+    if (holdMs > MAX_HOLD_MS) holdMs = MAX_HOLD_MS;
+    tap.x = x;
+    tap.y = y;
+    tap.pressedAt = now;
+    tap.releaseAt = now + holdMs;
+    tap.active = true;
+    tap.longFired = false;
+    queue(TouchEventType::PRESS, now);
+    tapsInjected++;
+}
+
+// Loop, every pass: long press, repeats and the release of a held tap
+inline void poll(uint32_t now) {
+    if (!tap.active) return;
+    if ((int32_t)(now - tap.releaseAt) >= 0) {
+        queue(TouchEventType::RELEASE, now);
+        tap.active = false;
+        return;
+    }
+    if (!tap.longFired && now - tap.pressedAt >= TouchInput::LONG_PRESS_MS) {
+        tap.longFired = true;
+        tap.lastRepeat = now;
+        queue(TouchEventType::LONG_PRESS, now);
+    } else if (tap.longFired && now - tap.lastRepeat >= TouchInput::REPEAT_MS) {
+        tap.lastRepeat = now;
+        queue(TouchEventType::REPEAT, now);
+    }
+}
+
+// Next injected event; rawX / rawY are already screen coordinates
+inline bool next(TouchEvent &ev) { return injected.pop(ev); }
+
+// Console: the rest of a 'T' command
+inline void readTap(Stream &in, uint32_t now) {
+    in.setTimeout(50);
+    const long x = in.parseInt();
+    const long y = in.parseInt();
+    long hold = TAP_MS;
+    if (in.peek() == ',') hold = in.parseInt();
+    if (x < 0 || y < 0 || x > INT16_MAX || y > INT16_MAX || hold < 0) return;
+    inject((int16_t)x, (int16_t)y, (uint16_t)hold, now);
+}
+
+// ---- Reports ----
+
+struct Sample {
+    uint32_t uptimeS;
+    uint32_t applied;        // Status frames applied (BrewStatus::seq)
+    uint32_t rxFrames, rxDropped, rxOverlong, rxHwOverruns, rxBadFrames;
+    uint32_t staleMaxMs;     // Worst status age seen by the UI since the last report
+    bool     connected;
+    uint32_t latP50Us, latP99Us, latMaxUs;  // rx -> pixel
+    uint32_t stackProtocol, stackLoop;      // High-water marks, bytes free
+};
+
+inline void print(Print &out, const Sample &s) {
+    out.printf("[SOAK] up=%u applied=%u rx=%u dropped=%u overlong=%u hwovr=%u bad=%u "
+               "stale_max=%u link=%u heap=%u heap_min=%u heap_big=%u "
+               "lat_p50=%u lat_p99=%u lat_max=%u taps=%u stk_proto=%u stk_loop=%u\n",
+               (unsigned)s.uptimeS, (unsigned)s.applied, (unsigned)s.rxFrames,
+               (unsigned)s.rxDropped, (unsigned)s.rxOverlong, (unsigned)s.rxHwOverruns,
+               (unsigned)s.rxBadFrames, (unsigned)s.staleMaxMs, s.connected ? 1u : 0u,
+               (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+               (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+               (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+               (unsigned)s.latP50Us, (unsigned)s.latP99Us, (unsigned)s.latMaxUs,
+               (unsigned)tapsInjected, (unsigned)s.stackProtocol, (unsigned)s.stackLoop);
+}
+
+}  // namespace Soak
+
+#endif  // BREW_SOAK
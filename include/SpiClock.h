@@ -0,0 +1,25 @@
+/**
+ * SpiClock.h - Runtime panel SPI clock, seen by TFT_eSPI
+ *
+ * platformio.ini force-includes this into every translation unit and
+ * defines SPI_FREQUENCY as brewSpiHz, so TFT_eSPI reads the write clock
+ * from this variable each time it opens a bus transaction (and once, in
+ * initDMA(), for the DMA device). PanelClock.h picks the value at boot;
+ * until then it is SPI_SAFE_FREQUENCY.
+ *
+ * Plain C, because it is included into the C sources as well.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint32_t brewSpiHz;  // Defined in main.cpp
+
+#ifdef __cplusplus
+}
+#endif
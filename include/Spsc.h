@@ -0,0 +1,146 @@
+/**
+ * Spsc.h - Lock-free primitives for handing data between the two cores
+ *
+ * SpscQueue<T, N>: bounded single-producer/single-consumer FIFO. push()
+ * fails instead of blocking when full, pop() fails when empty.
+ *
+ * SeqLock<T>: latest-value snapshot with one writer and any number of
+ * readers. The writer never waits; a reader that races a write simply
+ * retries its copy. Writer and readers must run on different cores (or the
+ * writer must not be preempted mid-write by a reader), since a reader spins
+ * while a write is in progress.
+ *
+ * LossyRing<T, N>: single-producer/single-consumer ring whose push()
+ * always succeeds. When the consumer falls N entries behind, the oldest
+ * entries are overwritten and pop() skips past them, counting them in
+ * dropped(). For producers that must never wait on a slow consumer.
+ * peek() + consume() let the consumer keep an entry it failed to pass on;
+ * if the producer overwrites it meanwhile, it counts as dropped like any
+ * other. The same rule as SeqLock applies: a pop() or peek() that races
+ * the overwrite of its slot spins until the write is done.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head{0};  // Written by producer
+    std::atomic<uint32_t> tail{0};  // Written by consumer
+
+public:
+    bool push(const T &item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) return false;
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        out = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) ==
+               head.load(std::memory_order_acquire);
+    }
+};
+
+template <typename T>
+class SeqLock {
+private:
+    std::atomic<uint32_t> seq{0};  // Odd while a write is in progress
+    T data{};
+
+public:
+    void write(const T &value) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        data = value;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Copy the latest value; returns its version (even, increases per write)
+    uint32_t read(T &out) const {
+        for (;;) {
+            uint32_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) continue;
+            out = data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1) return s1;
+        }
+    }
+
+    uint32_t version() const { return seq.load(std::memory_order_acquire); }
+};
+
+template <typename T, size_t N>
+class LossyRing {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};  // 2 * (n + 1) once entry n is in, odd while writing
+        T data{};
+    };
+
+    Slot slots[N];
+    std::atomic<uint32_t> head{0};  // Entries ever pushed; written by producer
+    uint32_t cursor = 0;            // Next entry to pop; consumer only
+    uint32_t lost = 0;              // Consumer only
+
+public:
+    void push(const T &item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        Slot &s = slots[h & (N - 1)];
+        s.seq.store(2 * h + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.data = item;
+        s.seq.store(2 * h + 2, std::memory_order_release);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Copy the oldest entry still held, leaving it in place
+    bool peek(T &out) {
+        for (;;) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (cursor == h) return false;
+            if (h - cursor > N) {
+                lost += h - cursor - N;
+                cursor = h - N;
+            }
+
+            const Slot &s = slots[cursor & (N - 1)];
+            uint32_t s1 = s.seq.load(std::memory_order_acquire);
+            if (s1 != 2 * cursor + 2) continue;  // Being overwritten
+            out = s.data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) != s1) continue;
+            return true;
+        }
+    }
+
+    // Done with the entry the last successful peek() returned
+    void consume() { cursor++; }
+
+    bool pop(T &out) {
+        if (!peek(out)) return false;
+        consume();
+        return true;
+    }
+
+    uint32_t dropped() const { return lost; }
+};
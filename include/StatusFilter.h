@@ -0,0 +1,161 @@
+/**
+ * StatusFilter.h - Smoothed, predicted temp / flow / volume between frames
+ *
+ * Status frames arrive every STATUS_STREAM_MS (200 ms), so raw readouts
+ * move in visible steps. The filter sits between pullStatus() and brew and
+ * gives the UI a value to show at every STEP_MS:
+ *
+ *   temp    last sample extrapolated along the Pico's tempRate
+ *   flow    last sample extrapolated along its own slope (sample to
+ *           sample, averaged), never below zero
+ *   volume  last sample plus flow integrated locally since then; never
+ *           runs backwards while the pump is on
+ *
+ * Each prediction is taken LEAD_MS ahead and fed through a fixed-point
+ * EMA (value += error >> ALPHA_SHIFT per step), which lags by about
+ * LEAD_MS: the two cancel on a steady ramp, and a new sample only moves
+ * the prediction by its error, which the EMA spreads over a few steps.
+ * Predictions stop growing MAX_PREDICT_MS after the last sample so a
+ * stalled link freezes the readouts instead of running them away. An
+ * error above a channel's snap threshold (new shot, step change) jumps
+ * straight to the sample.
+ *
+ * Values are Q8 fixed point in BrewStatus units (0.1 C, 0.1 mL/s, 0.1 mL).
+ * Only the displayed fields change; tempRate, the history and the shot log
+ * still see the Pico's own samples. Disconnected, the filter passes
+ * samples through unchanged.
+ *
+ * On by default; build with -D BREW_SMOOTHING=0 to show the raw samples
+ * (main skips the filter entirely).
+ *
+ * UI task only.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "BrewStatus.h"
+
+#ifndef BREW_SMOOTHING
+#define BREW_SMOOTHING 1
+#endif
+
+class StatusFilter {
+public:
+    static constexpr uint32_t STEP_MS        = 33;    // Animation step, ~30 fps
+    static constexpr uint8_t  ALPHA_SHIFT    = 2;     // EMA weight 1/4 per step
+    static constexpr uint32_t LEAD_MS        = STEP_MS * ((1 << ALPHA_SHIFT) - 1);
+    static constexpr uint32_t MAX_PREDICT_MS = 600;   // Three frames at 200 ms
+    static constexpr uint8_t  MAX_CATCHUP    = 8;     // Steps run after a long pass
+
+    // Errors beyond these are shown at once rather than eased
+    static constexpr int16_t SNAP_TEMP   = 20;  // 2.0 C
+    static constexpr int16_t SNAP_FLOW   = 15;  // 1.5 mL/s
+    static constexpr int16_t SNAP_VOLUME = 50;  // 5.0 mL
+
+private:
+    static constexpr uint8_t Q = 8;
+
+    struct Track {
+        int32_t base  = 0;  // Last sample, Q8
+        int32_t slope = 0;  // Q8 units per second
+        int32_t value = 0;  // Smoothed output, Q8
+
+        void reset(int16_t v) {
+            base = value = (int32_t)v << Q;
+            slope = 0;
+        }
+
+        int32_t predict(uint32_t ageMs) const {
+            uint32_t ahead = ageMs + LEAD_MS;
+            if (ahead > MAX_PREDICT_MS) ahead = MAX_PREDICT_MS;
+            return base + (int32_t)((int64_t)slope * ahead / 1000);
+        }
+
+        void ease(int32_t target, int16_t snap) {
+            const int32_t err = target - value;
+            if (err > ((int32_t)snap << Q) || err < -((int32_t)snap << Q)) value = target;
+            else value += err >> ALPHA_SHIFT;
+        }
+
+        int16_t out() const { return (int16_t)((value + (1 << (Q - 1))) >> Q); }
+    };
+
+    Track temp, flow, volume;
+    int16_t  lastFlow = 0;     // Raw, for the flow slope
+    uint32_t sampleMs = 0;
+    uint32_t stepMs = 0;
+    bool     live = false;     // Connected and primed
+    bool     pumping = false;
+
+    void tick(uint32_t at) {
+        const uint32_t age = at - sampleMs;
+        temp.ease(temp.predict(age), SNAP_TEMP);
+
+        flow.ease(flow.predict(age), SNAP_FLOW);
+        if (flow.value < 0) flow.value = 0;
+
+        volume.slope = pumping ? flow.value : 0;
+        const int32_t before = volume.value;
+        volume.ease(volume.predict(age), SNAP_VOLUME);
+        if (pumping && volume.value < before &&
+            before - volume.value <= ((int32_t)SNAP_VOLUME << Q)) {
+            volume.value = before;
+        }
+    }
+
+public:
+    // A new status snapshot arrived
+    void sample(const BrewStatus &s, uint32_t now) {
+        if (!s.connected || !live) {
+            temp.reset(s.temp);
+            flow.reset(s.flow);
+            volume.reset(s.volume);
+            lastFlow = s.flow;
+            sampleMs = stepMs = now;
+            live = s.connected;
+            pumping = s.pump;
+            return;
+        }
+
+        const uint32_t gap = now - sampleMs;
+        pumping = s.pump || s.flow > 0;
+
+        temp.base = (int32_t)s.temp << Q;
+        temp.slope = ((int32_t)s.tempRate << Q) / 10;  // 0.01 C/s -> 0.1 C/s
+
+        int32_t flowSlope = 0;
+        if (pumping && gap > 0) {
+            flowSlope = (int32_t)(((int64_t)(s.flow - lastFlow) << Q) * 1000 / gap);
+        }
+        flow.base = (int32_t)s.flow << Q;
+        flow.slope = (flow.slope + flowSlope) / 2;
+        lastFlow = s.flow;
+
+        volume.base = (int32_t)s.volume << Q;
+
+        sampleMs = now;
+        tick(now);
+        stepMs = now;
+    }
+
+    // Step the animation to `now` and write the shown values into `b`.
+    // Returns true if any of them changed.
+    bool update(BrewStatus &b, uint32_t now) {
+        if (live) {
+            uint8_t n = 0;
+            while (now - stepMs >= STEP_MS && n++ < MAX_CATCHUP) {
+                stepMs += STEP_MS;
+                tick(stepMs);
+            }
+            if (now - stepMs >= STEP_MS) stepMs = now;
+        }
+
+        const uint16_t before = b.dirty;
+        b.set(b.temp,   temp.out(),   (uint16_t)BF_TEMP);
+        b.set(b.flow,   flow.out(),   (uint16_t)BF_FLOW);
+        b.set(b.volume, volume.out(), (uint16_t)BF_VOLUME);
+        return b.dirty != before;
+    }
+};
@@ -0,0 +1,124 @@
+/**
+ * TimeSeries.h - Fixed-memory shot history with min/max decimation
+ *
+ * TimeSeries<N, LEVELS> keeps the last N samples of the brew telemetry at
+ * each of LEVELS zoom levels. Level 0 holds raw samples; every entry of
+ * level k summarizes DECIMATION^k raw samples as the min and max of each
+ * channel, so a zoomed-out plot still shows every spike. All storage is
+ * inline and push() never allocates.
+ *
+ * Entries are addressed oldest-first (at(level, 0) is the oldest still
+ * held). total(level) counts every entry a level has ever completed, which
+ * lets a plot tell how many new entries arrived since it last drew.
+ *
+ * Single-threaded: written and read from the UI loop.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TelemetrySample {
+    int16_t temp;      // 0.1 C
+    int16_t flow;      // 0.1 mL/s
+    int16_t volume;    // 0.1 mL
+    int16_t tempRate;  // 0.01 C/s
+};
+
+struct TelemetrySpan {
+    TelemetrySample lo, hi;
+
+    static TelemetrySpan of(const TelemetrySample &s) { return { s, s }; }
+
+    void include(const TelemetrySample &s) {
+        grow(lo.temp, hi.temp, s.temp);
+        grow(lo.flow, hi.flow, s.flow);
+        grow(lo.volume, hi.volume, s.volume);
+        grow(lo.tempRate, hi.tempRate, s.tempRate);
+    }
+
+    void include(const TelemetrySpan &o) {
+        include(o.lo);
+        include(o.hi);
+    }
+
+private:
+    static void grow(int16_t &lo, int16_t &hi, int16_t v) {
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+};
+
+template <uint16_t N, uint8_t LEVELS>
+class TimeSeries {
+    static_assert(LEVELS >= 1, "need at least the raw level");
+
+public:
+    static constexpr uint8_t DECIMATION = 4;
+
+    // Raw samples per entry at `level`
+    static constexpr uint32_t span(uint8_t level) {
+        return level == 0 ? 1 : DECIMATION * span(level - 1);
+    }
+
+private:
+    TelemetrySample raw[N];
+    TelemetrySpan   levels[LEVELS > 1 ? LEVELS - 1 : 1][N];
+
+    uint32_t      completed[LEVELS] = {};   // Entries ever written per level
+    TelemetrySpan pending[LEVELS] = {};     // Partial entry being folded into level k
+    uint8_t       pendingCount[LEVELS] = {};
+
+    void append(uint8_t level, const TelemetrySpan &e) {
+        levels[level - 1][completed[level] % N] = e;
+        completed[level]++;
+        fold(level, e);
+    }
+
+    // Fold a finished level-k entry into level k+1
+    void fold(uint8_t level, const TelemetrySpan &e) {
+        if (level + 1 >= LEVELS) return;
+        uint8_t next = level + 1;
+        if (pendingCount[next] == 0) pending[next] = e;
+        else pending[next].include(e);
+        if (++pendingCount[next] == DECIMATION) {
+            pendingCount[next] = 0;
+            append(next, pending[next]);
+        }
+    }
+
+public:
+    void push(const TelemetrySample &s) {
+        raw[completed[0] % N] = s;
+        completed[0]++;
+        fold(0, TelemetrySpan::of(s));
+    }
+
+    void clear() {
+        for (uint8_t i = 0; i < LEVELS; i++) {
+            completed[i] = 0;
+            pendingCount[i] = 0;
+        }
+    }
+
+    static constexpr uint16_t capacity() { return N; }
+    static constexpr uint8_t levelCount() { return LEVELS; }
+
+    uint32_t total(uint8_t level) const { return completed[level]; }
+
+    uint16_t size(uint8_t level) const {
+        return completed[level] < N ? (uint16_t)completed[level] : N;
+    }
+
+    // Entry by its absolute number (total(level) - size(level) <= n < total(level))
+    TelemetrySpan entry(uint8_t level, uint32_t n) const {
+        if (level == 0) return TelemetrySpan::of(raw[n % N]);
+        return levels[level - 1][n % N];
+    }
+
+    // i-th oldest entry held at `level` (i < size(level))
+    TelemetrySpan at(uint8_t level, uint16_t i) const {
+        return entry(level, completed[level] - size(level) + i);
+    }
+};
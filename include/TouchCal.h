@@ -0,0 +1,141 @@
+/**
+ * TouchCal.h - Touch panel calibration stored as a fixed-point affine map
+ *
+ * Raw XPT2046 readings map to screen pixels through
+ *
+ *   | sx |   | a  b  c |   | rx |
+ *   | sy | = | d  e  f | * | ry |
+ *   | 1  |   | 0  0  1 |   | 1  |
+ *
+ * with the six coefficients held in Q16. Because x and y both depend on both
+ * raw axes, a panel mounted rotated or slightly skewed still maps correctly,
+ * which independent per-axis min/max ranges can't do. Mapping a point costs
+ * six integer multiply-adds.
+ *
+ * solve() fits the matrix by least squares from the calibration points
+ * (floating point, once per calibration). load()/save() keep it in NVS so
+ * calibration survives a reboot.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <math.h>
+
+struct TouchCal {
+    static constexpr int32_t  ONE     = 1 << 16;
+    static constexpr uint16_t VERSION = 1;  // Bump if the stored layout changes
+
+    // a b c / d e f, Q16
+    int32_t m[6];
+    bool    valid = false;  // Loaded from NVS or freshly calibrated
+
+    TouchCal() { setDefault(); }
+
+    // Raw 300..3800 on both axes across a 240x320 panel
+    void setDefault() {
+        m[0] = (int32_t)(239.0f / 3500.0f * ONE);
+        m[1] = 0;
+        m[2] = -300 * m[0];
+        m[3] = 0;
+        m[4] = (int32_t)(319.0f / 3500.0f * ONE);
+        m[5] = -300 * m[4];
+        valid = false;
+    }
+
+    // Raw -> screen, clamped to [0, w) x [0, h)
+    void map(int16_t rx, int16_t ry, int16_t w, int16_t h,
+             int16_t &sx, int16_t &sy) const {
+        int32_t x = (int32_t)(((int64_t)m[0] * rx + (int64_t)m[1] * ry + m[2] + ONE / 2) >> 16);
+        int32_t y = (int32_t)(((int64_t)m[3] * rx + (int64_t)m[4] * ry + m[5] + ONE / 2) >> 16);
+        sx = x < 0 ? 0 : x >= w ? w - 1 : x;
+        sy = y < 0 ? 0 : y >= h ? h - 1 : y;
+    }
+
+    /**
+     * Least-squares fit from n >= 3 point pairs (screen s*, raw r*).
+     * Returns false and leaves the matrix alone if the raw points are
+     * degenerate (collinear or all the same).
+     */
+    bool solve(const int16_t *sxs, const int16_t *sys,
+               const int16_t *rxs, const int16_t *rys, uint8_t n) {
+        // Normal equations: (A^T A) p = A^T s, A rows = [rx ry 1]
+        double xx = 0, xy = 0, x1 = 0, yy = 0, y1 = 0;
+        double bx[3] = { 0, 0, 0 }, by[3] = { 0, 0, 0 };
+        for (uint8_t i = 0; i < n; i++) {
+            double rx = rxs[i], ry = rys[i];
+            xx += rx * rx; xy += rx * ry; x1 += rx;
+            yy += ry * ry; y1 += ry;
+            bx[0] += rx * sxs[i]; bx[1] += ry * sxs[i]; bx[2] += sxs[i];
+            by[0] += rx * sys[i]; by[1] += ry * sys[i]; by[2] += sys[i];
+        }
+        const double A[3][3] = { { xx, xy, x1 }, { xy, yy, y1 }, { x1, y1, (double)n } };
+
+        double det = det3(A);
+        if (fabs(det) < 1e-6) return false;
+
+        double px[3], py[3];
+        cramer(A, det, bx, px);
+        cramer(A, det, by, py);
+
+        for (uint8_t i = 0; i < 3; i++) {
+            m[i]     = (int32_t)lround(px[i] * ONE);
+            m[3 + i] = (int32_t)lround(py[i] * ONE);
+        }
+        valid = true;
+        return true;
+    }
+
+    // RMS distance in pixels between the fitted and the target points
+    float residual(const int16_t *sxs, const int16_t *sys,
+                   const int16_t *rxs, const int16_t *rys, uint8_t n) const {
+        float sum = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            int16_t x, y;
+            map(rxs[i], rys[i], INT16_MAX, INT16_MAX, x, y);
+            float dx = x - sxs[i], dy = y - sys[i];
+            sum += dx * dx + dy * dy;
+        }
+        return n ? sqrtf(sum / n) : 0;
+    }
+
+    // Restore from NVS. Returns false (keeping defaults) if nothing valid is stored.
+    bool load() {
+        Preferences prefs;
+        if (!prefs.begin("touchcal", true)) return false;
+        int32_t stored[6];
+        bool ok = prefs.getUShort("ver", 0) == VERSION &&
+                  prefs.getBytes("m", stored, sizeof(stored)) == sizeof(stored);
+        prefs.end();
+        if (!ok) return false;
+        memcpy(m, stored, sizeof(m));
+        valid = true;
+        return true;
+    }
+
+    bool save() const {
+        Preferences prefs;
+        if (!prefs.begin("touchcal", false)) return false;
+        bool ok = prefs.putBytes("m", m, sizeof(m)) == sizeof(m) &&
+                  prefs.putUShort("ver", VERSION) == sizeof(uint16_t);
+        prefs.end();
+        return ok;
+    }
+
+private:
+    static double det3(const double M[3][3]) {
+        return M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+             - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+             + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+    }
+
+    static void cramer(const double M[3][3], double det, const double *b, double *out) {
+        for (uint8_t c = 0; c < 3; c++) {
+            double T[3][3];
+            for (uint8_t r = 0; r < 3; r++)
+                for (uint8_t k = 0; k < 3; k++) T[r][k] = (k == c) ? b[r] : M[r][k];
+            out[c] = det3(T) / det;
+        }
+    }
+};
@@ -0,0 +1,161 @@
+/**
+ * TouchInput.h - IRQ-gated XPT2046 sampling with a touch event queue
+ *
+ * The XPT2046 pulls TOUCH_IRQ low when the panel is pressed, and the
+ * XPT2046_Touchscreen driver latches that in its own ISR (see
+ * tirqTouched()). poll() checks only that latch while idle, so an untouched
+ * panel causes no SPI traffic at all. Once pressed it samples every
+ * SAMPLE_MS, smooths the readings through a 3-sample median and an IIR
+ * filter, and queues events:
+ *
+ *   PRESS       first stable contact
+ *   LONG_PRESS  held for LONG_PRESS_MS
+ *   REPEAT      every REPEAT_MS after a long press (for hold-to-ramp)
+ *   RELEASE     no contact for RELEASE_MS
+ *
+ * The controller shares the panel's SPIClass, and a compositor frame keeps
+ * that bus in a transaction across loop() passes. poll(now, false) reads
+ * nothing while it does: a press stays latched and is sampled on the first
+ * pass with the bus free, and a held finger just skips those samples.
+ *
+ * Taps are separated by releases rather than a fixed lockout, so fast
+ * repeated taps all register. Events carry raw coordinates plus a
+ * millisecond timestamp; mapping to screen space is left to the caller.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <XPT2046_Touchscreen.h>
+
+#include "Spsc.h"
+
+enum class TouchEventType : uint8_t { PRESS, LONG_PRESS, REPEAT, RELEASE };
+
+struct TouchEvent {
+    TouchEventType type;
+    int16_t  rawX, rawY;
+    uint32_t ms;
+};
+
+class TouchInput {
+public:
+    static constexpr uint32_t SAMPLE_MS     = 10;
+    static constexpr uint32_t RELEASE_MS    = 40;
+    static constexpr uint32_t LONG_PRESS_MS = 600;
+    static constexpr uint32_t REPEAT_MS     = 150;
+    static constexpr int16_t  PRESSURE_MIN  = 200;
+
+private:
+    XPT2046_Touchscreen &ts;
+    SpscQueue<TouchEvent, 16> events;
+
+    bool     down = false;
+    bool     longFired = false;
+    uint32_t lastSample = 0;
+    uint32_t lastContact = 0;
+    uint32_t pressedAt = 0;
+    uint32_t lastRepeat = 0;
+
+    // Median window + IIR state
+    int16_t  histX[3], histY[3];
+    uint8_t  histLen = 0;
+    int32_t  fx = 0, fy = 0;  // Filtered position, 4 fractional bits
+
+    static int16_t median3(const int16_t *v) {
+        int16_t a = v[0], b = v[1], c = v[2];
+        if (a > b) { int16_t t = a; a = b; b = t; }
+        if (b > c) { b = c; }
+        return a > b ? a : b;
+    }
+
+    void push(TouchEventType type, uint32_t now) {
+        TouchEvent ev = { type, (int16_t)(fx >> 4), (int16_t)(fy >> 4), now };
+        events.push(ev);  // A full queue drops the newest event
+    }
+
+    void addSample(int16_t x, int16_t y) {
+        if (histLen < 3) {
+            histLen++;
+        } else {
+            histX[0] = histX[1]; histX[1] = histX[2];
+            histY[0] = histY[1]; histY[1] = histY[2];
+        }
+        histX[histLen - 1] = x;
+        histY[histLen - 1] = y;
+
+        int16_t mx = histLen == 3 ? median3(histX) : x;
+        int16_t my = histLen == 3 ? median3(histY) : y;
+
+        if (histLen == 1) {
+            fx = (int32_t)mx << 4;
+            fy = (int32_t)my << 4;
+        } else {
+            // y += (x - y) / 2
+            fx += (((int32_t)mx << 4) - fx) / 2;
+            fy += (((int32_t)my << 4) - fy) / 2;
+        }
+    }
+
+public:
+    explicit TouchInput(XPT2046_Touchscreen &touch) : ts(touch) {}
+
+    // Sample the panel if the IRQ says it's pressed. Call every loop();
+    // spiFree false while a panel frame holds the SPI bus.
+    void poll(uint32_t now, bool spiFree = true) {
+        if (!down && !ts.tirqTouched()) return;  // Idle: no SPI
+        if (!spiFree) return;                    // Sample once the frame is out
+        if (now - lastSample < SAMPLE_MS) return;
+        lastSample = now;
+
+        bool contact = false;
+        if (ts.touched()) {
+            TS_Point p = ts.getPoint();
+            if (p.z > PRESSURE_MIN) {
+                contact = true;
+                lastContact = now;
+                addSample(p.x, p.y);
+            }
+        }
+
+        if (!down) {
+            if (contact) {
+                down = true;
+                longFired = false;
+                pressedAt = now;
+                push(TouchEventType::PRESS, now);
+            } else {
+                histLen = 0;
+            }
+            return;
+        }
+
+        if (!contact) {
+            if (now - lastContact >= RELEASE_MS) {
+                down = false;
+                histLen = 0;
+                push(TouchEventType::RELEASE, now);
+            }
+            return;
+        }
+
+        if (!longFired && now - pressedAt >= LONG_PRESS_MS) {
+            longFired = true;
+            lastRepeat = now;
+            push(TouchEventType::LONG_PRESS, now);
+        } else if (longFired && now - lastRepeat >= REPEAT_MS) {
+            lastRepeat = now;
+            push(TouchEventType::REPEAT, now);
+        }
+    }
+
+    bool next(TouchEvent &ev) { return events.pop(ev); }
+
+    // Forget any press in progress (e.g. after another screen used the panel)
+    void reset() {
+        down = false;
+        histLen = 0;
+        TouchEvent ev;
+        while (events.pop(ev)) {}
+    }
+};
@@ -0,0 +1,176 @@
+/**
+ * UartRx.h - Interrupt-fed line framer for the Pico UART link
+ *
+ * The UART driver ISR drains the hardware FIFO into its own ring buffer and
+ * wakes the HardwareSerial event task, which calls feed() with whatever
+ * arrived. feed() frames bytes on '\n' directly into a ring of fixed line
+ * slots, so frames are assembled while loop() is busy redrawing and never
+ * copied again: the consumer gets a span pointing into the slot, parses it
+ * in place, then releases the slot.
+ *
+ * Single producer (UART event task) / single consumer (loop) — the slot
+ * indices are the only shared state and are published with release/acquire
+ * ordering.
+ *
+ * Binary frames (PicoProtocol.h) are recognised by their SYNC byte and
+ * framed by their length field into the same slots, so JSON lines and
+ * binary frames can be mixed freely on the wire.
+ *
+ * Lines that arrive while every slot is full are dropped whole; lines longer
+ * than LINE_LEN are discarded up to the next '\n'. Both are counted.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "PicoProtocol.h"
+
+struct RxSpan {
+    const char *data;
+    uint16_t    len;
+    bool        binary;  // PicoProto frame (after SYNC) rather than a text line
+};
+
+struct UartRxStats {
+    uint32_t frames;      // Lines handed to the consumer
+    uint32_t dropped;     // Lines lost because every slot was full
+    uint32_t overlong;    // Lines longer than a slot
+    uint32_t hwOverruns;  // UART FIFO / driver buffer overflows
+    uint32_t badFrames;   // Binary frames rejected by the consumer (CRC, length)
+};
+
+template <size_t SLOTS, size_t LINE_LEN>
+class UartLineRing {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+    static_assert(LINE_LEN >= PicoProto::MAX_FRAME_LEN, "slots must fit a binary frame");
+
+private:
+    char     slots[SLOTS][LINE_LEN + 1];
+    uint16_t lens[SLOTS];
+    bool     isBinary[SLOTS];
+
+    std::atomic<uint32_t> head{0};  // Next slot the producer fills
+    std::atomic<uint32_t> tail{0};  // Next slot the consumer reads
+
+    // Producer-only state
+    uint16_t fill = 0;
+    bool     discarding = false;
+    bool     inBinary = false;   // Collecting a binary frame
+    uint16_t binRemaining = 0;   // Bytes left once the length is known
+
+    volatile uint32_t nFrames = 0;
+    volatile uint32_t nDropped = 0;
+    volatile uint32_t nOverlong = 0;
+    volatile uint32_t nHwOverruns = 0;
+    uint32_t nBadFrames = 0;  // Consumer-owned
+
+    bool claimSlot(uint32_t h) {
+        if (h - tail.load(std::memory_order_acquire) >= SLOTS) {
+            // Consumer is behind — lose this frame, keep the queued ones
+            discarding = true;
+            nDropped = nDropped + 1;
+            return false;
+        }
+        return true;
+    }
+
+    void publish(uint32_t h, bool binary) {
+        uint32_t idx = h & (SLOTS - 1);
+        slots[idx][fill] = '\0';
+        lens[idx] = fill;
+        isBinary[idx] = binary;
+        head.store(h + 1, std::memory_order_release);
+        nFrames = nFrames + 1;
+    }
+
+    void feedBinary(uint32_t h, uint8_t c) {
+        if (!discarding) slots[h & (SLOTS - 1)][fill] = (char)c;
+        fill++;
+
+        if (fill == 2) {
+            // type, len known: rest is payload + crc
+            binRemaining = (uint8_t)c + 2;
+            return;
+        }
+        if (fill > 2 && --binRemaining == 0) {
+            if (!discarding) publish(h, true);
+            inBinary = false;
+            discarding = false;
+            fill = 0;
+        }
+    }
+
+public:
+    // ---- Producer side (UART event task) ----
+
+    void feed(const uint8_t *data, size_t n) {
+        for (size_t i = 0; i < n; i++) feedByte(data[i]);
+    }
+
+    void feedByte(uint8_t c) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+
+        if (inBinary) {
+            feedBinary(h, c);
+            return;
+        }
+
+        if (c == PicoProto::SYNC) {
+            // Start of a binary frame; any partial text line is abandoned
+            inBinary = true;
+            fill = 0;
+            discarding = !claimSlot(h);
+            return;
+        }
+
+        if (c == '\n') {
+            if (!discarding && fill > 0) publish(h, false);
+            fill = 0;
+            discarding = false;
+            return;
+        }
+
+        if (discarding || c < 32 || c >= 127) return;
+
+        if (fill == 0 && !claimSlot(h)) return;
+
+        if (fill >= LINE_LEN) {
+            discarding = true;
+            fill = 0;
+            nOverlong = nOverlong + 1;
+            return;
+        }
+
+        slots[h & (SLOTS - 1)][fill++] = (char)c;
+    }
+
+    void noteHwOverrun() { nHwOverruns = nHwOverruns + 1; }
+
+    // Called by the consumer when a binary frame fails to decode
+    void noteBadFrame() { nBadFrames++; }
+
+    // ---- Consumer side (loop) ----
+
+    // Oldest complete line, valid until release()
+    bool peek(RxSpan &out) const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        uint32_t idx = t & (SLOTS - 1);
+        out.data = slots[idx];
+        out.len  = lens[idx];
+        out.binary = isBinary[idx];
+        return true;
+    }
+
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    UartRxStats stats() const {
+        return { nFrames, nDropped, nOverlong, nHwOverruns, nBadFrames };
+    }
+};
@@ -0,0 +1,131 @@
+/**
+ * WidgetArena.h - Bump allocator for a screen's widgets
+ *
+ * A screen reserves one block sized for all of its widgets and constructs
+ * them in place with make<T>(...). Tearing the screen down runs the
+ * destructors and frees that single block, so building and dropping screens
+ * doesn't scatter small widget allocations across the heap.
+ *
+ * The block is either malloc'd by reserve() or supplied by the owner with
+ * adopt(). A WidgetStorage<BYTES> member gives a screen an inline block
+ * sized at compile time, so building it allocates nothing at all.
+ *
+ * If the block can't be reserved, or a screen outgrows its estimate,
+ * make() falls back to new, so a wrong size costs fragmentation rather
+ * than a crash. overflowed() reports when that has happened.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+#include <utility>
+
+class WidgetArena {
+public:
+    static constexpr uint8_t MAX_OBJECTS = 40;
+    static constexpr size_t  ALIGN = alignof(max_align_t);
+
+    // Bytes to reserve for one T, alignment padding included
+    template <typename T>
+    static constexpr size_t slot() { return (sizeof(T) + ALIGN - 1) & ~(ALIGN - 1); }
+
+private:
+    struct Entry {
+        void *obj;
+        void (*destroy)(void *obj, bool onHeap);
+        bool  onHeap;
+    };
+
+    uint8_t *block = nullptr;
+    size_t   capacity = 0;
+    size_t   used = 0;
+    Entry    entries[MAX_OBJECTS];
+    uint8_t  count = 0;
+    bool     spilled = false;
+    bool     owned = false;   // block came from reserve()
+
+    template <typename T>
+    static void destroyAs(void *obj, bool onHeap) {
+        if (onHeap) delete static_cast<T *>(obj);
+        else static_cast<T *>(obj)->~T();
+    }
+
+public:
+    WidgetArena() = default;
+    WidgetArena(const WidgetArena &) = delete;
+    WidgetArena &operator=(const WidgetArena &) = delete;
+    ~WidgetArena() { release(); }
+
+    // Allocate the block (no-op if already reserved). False if out of memory.
+    bool reserve(size_t bytes) {
+        if (block) return true;
+        block = (uint8_t *)malloc(bytes);
+        capacity = block ? bytes : 0;
+        used = 0;
+        owned = block != nullptr;
+        return block != nullptr;
+    }
+
+    // Use caller-owned storage (ALIGN-aligned, outliving the arena) as the block
+    void adopt(void *storage, size_t bytes) {
+        if (block) return;
+        block = (uint8_t *)storage;
+        capacity = bytes;
+        used = 0;
+        owned = false;
+    }
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args) {
+        const size_t need = slot<T>();
+        bool inBlock = block && used + need <= capacity && count < MAX_OBJECTS;
+        T *obj;
+        if (inBlock) {
+            obj = new (block + used) T(std::forward<Args>(args)...);
+            used += need;
+        } else {
+            obj = new T(std::forward<Args>(args)...);
+            spilled = true;
+        }
+        if (count < MAX_OBJECTS) {
+            entries[count++] = { obj, &destroyAs<T>, !inBlock };
+        }
+        // else: an untracked heap object that reset() can't free; MAX_OBJECTS
+        // is sized well above any screen so this never happens in practice
+        return obj;
+    }
+
+    // Destroy everything (newest first) but keep the block for reuse
+    void reset() {
+        while (count) {
+            Entry &e = entries[--count];
+            e.destroy(e.obj, e.onHeap);
+        }
+        used = 0;
+        spilled = false;
+    }
+
+    // Destroy everything and give a reserved block back to the heap
+    void release() {
+        reset();
+        if (owned) free(block);
+        block = nullptr;
+        capacity = 0;
+        owned = false;
+    }
+
+    bool   reserved() const { return block != nullptr; }
+    bool   overflowed() const { return spilled; }
+    size_t bytesUsed() const { return used; }
+    size_t bytesReserved() const { return capacity; }
+};
+
+// Inline, compile-time-sized block for WidgetArena::adopt()
+template <size_t BYTES>
+struct WidgetStorage {
+    static constexpr size_t SIZE = BYTES;
+    alignas(WidgetArena::ALIGN) uint8_t bytes[BYTES];
+};
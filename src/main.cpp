@@ -5,8 +5,9 @@
  * Now powered by ForgeUI — shared UI library for CodeLab projects.
  *
  * Communicates with BrewForge Pico 2W via UART:
- *   - Receives JSON status updates
- *   - Sends single-char commands (brew, stop, next, etc.)
+ *   - Receives JSON or binary status updates (see PicoProtocol.h)
+ *   - Subscribes to a pushed status stream (no polling)
+ *   - Sends acked, sequence-numbered commands (see CommandChannel.h)
  *
  * Hardware:
  *   Display (HSPI): MOSI=13, MISO=12, CLK=14, CS=15, DC=2, RST=4, BL=21
@@ -27,34 +28,36 @@
 #include <ForgeUI.h>
 #include <drivers/TFT_eSPI_Driver.h>
 
-// BrewStatus must be defined before BrewScreen includes it
-struct BrewStatus {
-    float temp = 0;
-    float tempF = 0;
-    float target = 93.0;
-    float flow = 0;
-    float volume = 0;
-    char state[16] = "IDLE";
-    int step = 0;
-    int stepElapsed = 0;
-    int stepTime = 0;
-    bool pump = false;
-    bool boiler = false;
-    bool solenoid = false;
-    bool warmer = false;
-    float tempRate = 0;
-    bool connected = false;
-    unsigned long lastUpdate = 0;
-};
-
+#include "BrewStatus.h"
+#include "BrewJson.h"
+#include "PicoProtocol.h"
+#include "CommandChannel.h"
+#include "UartRx.h"
+#include "Spsc.h"
+#include "TouchInput.h"
+#include "Profiler.h"
+#include "FixedFmt.h"
+#include "FramePacer.h"
+#include "Bench.h"
+#include "Compositor.h"
+#include "PanelClock.h"
 #include "CalibrationScreen.h"
+#include "BootTrace.h"
 #include "BrewScreen.h"
+#include "GraphScreen.h"
+#include "PanelScroll.h"
+#include "LazyScreen.h"
+#include "ShotLog.h"
+#include "Soak.h"
+#include "StatusFilter.h"
+#include "NetBridge.h"
+#include "OtaUpdate.h"
 
 // ===================== HARDWARE PINS =====================
 
 #define TFT_BL 21
 
-// Touch controller - SEPARATE SPI bus from display
+// Touch controller - own pins, same SPIClass as the display
 #define TOUCH_MOSI 32
 #define TOUCH_MISO 39
 #define TOUCH_CLK  25
@@ -64,181 +67,661 @@ struct BrewStatus {
 // UART to BrewForge Pico
 #define PICO_RX 16
 #define PICO_TX 17
+#ifndef PICO_BAUD
 #define PICO_BAUD 115200
+#endif
 
 // ===================== OBJECTS =====================
 
+uint32_t brewSpiHz = SPI_SAFE_FREQUENCY;  // Panel write clock (SpiClock.h)
 TFT_eSPI tft = TFT_eSPI();
 TFT_eSPI_Driver gfxDriver(tft);
+Compositor compositor(tft, 240, 320);
+PanelScroll panelScroll(tft, 320);
+bool frameCompleted = false;  // Set by the compositor's frame-complete callback
+FramePacer pacer;             // Refresh tick, backlight, idle mode
 XPT2046_Touchscreen touch(TOUCH_CS, TOUCH_IRQ);
 HardwareSerial PicoSerial(2);
 
-// Theme + Screen Manager
+// Theme + Screen Manager (lazy screens are built on first show and
+// reclaimed after RECLAIM_IDLE_MS off-screen)
 ForgeTheme theme = forgeThemeDark(240, 320);
-ScreenManager screenMgr;
+LazyScreenManager screenMgr;
 
 // Screen indices
-int brewScreenIdx = -1;
-int calScreenIdx  = -1;
+int brewScreenIdx  = -1;
+int calScreenIdx   = -1;
+int graphScreenIdx = -1;
 
 // Screens
 BrewScreen *brewScreen = nullptr;
 CalibrationScreen *calScreen = nullptr;
+GraphScreen *graphScreen = nullptr;
 
 // ===================== TOUCH =====================
 
-TouchCal touchCal;  // Defined in CalibrationScreen.h
-bool touchWasPressed = false;
-unsigned long lastTouchTime = 0;
-#define TOUCH_DEBOUNCE_MS 200
-#define TOUCH_PRESSURE_MIN 200
+TouchCal touchCal;  // Restored from NVS in setup()
+TouchInput touchInput(touch);
 
 struct ScreenPoint { int16_t x, y; };
 
 ScreenPoint mapTouch(int16_t rawX, int16_t rawY) {
     ScreenPoint s;
-    s.x = map(rawX, touchCal.xMin, touchCal.xMax, 0, 239);
-    s.y = map(rawY, touchCal.yMin, touchCal.yMax, 0, 319);
-    s.x = constrain(s.x, 0, 239);
-    s.y = constrain(s.y, 0, 319);
+    touchCal.map(rawX, rawY, 240, 320, s.x, s.y);
     return s;
 }
 
 // ===================== BREW STATUS =====================
-
-BrewStatus brew;
+//
+// Two cores, two owners:
+//   core 0  protocolTask  — PicoSerial, parsing, subscription, picoBrew
+//   core 1  loop()        — touch, screens, rendering, brew
+// picoBrew is published through a seqlock after every change and loop()
+// merges the latest snapshot into brew. Commands go the other way through
+// an SPSC queue. Neither side ever blocks on the other.
+
+BrewStatus picoBrew;                 // Protocol task only
+BrewStatus brew;                     // UI only (BrewScreen reads this)
+BrewStatus latest;                   // UI only: last snapshot as the Pico sent it
+SeqLock<BrewStatus> statusChannel;
+uint32_t statusVersionSeen = 0;
+
+#define CMD_QUEUE_LEN 16
+SpscQueue<PicoCommand, CMD_QUEUE_LEN> cmdQueue;
+
+#define PROTOCOL_CORE       0
+#define PROTOCOL_STACK      4096
+#define PROTOCOL_PRIORITY   5
+#define PROTOCOL_TICK_MS    20   // Max sleep between protocol passes
+TaskHandle_t protocolTaskHandle = nullptr;
+TaskHandle_t loopTaskHandle = nullptr;
 
 // ===================== UART PARSING =====================
 
-String uartBuffer = "";
-
-float jsonFloat(const String& json, const char* key) {
-    String search = String("\"") + key + "\":";
-    int idx = json.indexOf(search);
-    if (idx == -1) return 0;
-    idx += search.length();
-    int end = idx;
-    while (end < (int)json.length() &&
-           (isDigit(json[end]) || json[end] == '.' || json[end] == '-'))
-        end++;
-    return json.substring(idx, end).toFloat();
+// Lines are framed by the UART event task into fixed slots (see UartRx.h)
+#define UART_RX_SLOTS 4
+#define UART_DRIVER_RX_BUF 2048
+UartLineRing<UART_RX_SLOTS, BrewJson::MAX_FRAME_LEN> uartRx;
+UartRxStats uartRxReported = {};
+
+// Arrival time of the latest UART bytes, for rx -> pixel latency
+std::atomic<uint32_t> lastRxMicros{0};
+
+void onPicoReceive() {
+    uint8_t chunk[64];
+    size_t n;
+    while ((n = PicoSerial.read(chunk, sizeof(chunk))) > 0) {
+        uartRx.feed(chunk, n);
+    }
+    lastRxMicros.store(Prof::micros32(), std::memory_order_relaxed);
+    if (protocolTaskHandle) xTaskNotifyGive(protocolTaskHandle);
 }
 
-int jsonInt(const String& json, const char* key) {
-    return (int)jsonFloat(json, key);
+void onPicoReceiveError(hardwareSerial_error_t err) {
+    if (err == UART_FIFO_OVF_ERROR || err == UART_BUFFER_FULL_ERROR) {
+        uartRx.noteHwOverrun();
+    }
 }
 
-bool jsonBool(const String& json, const char* key) {
-    String search = String("\"") + key + "\":";
-    int idx = json.indexOf(search);
-    if (idx == -1) return false;
-    idx += search.length();
-    return json.substring(idx, idx + 4) == "true";
+// Ask the Pico for compact binary frames once it is talking to us.
+// If it ignores the request we simply keep receiving JSON.
+#define PICO_PREFER_BINARY 1
+bool binaryRequested = false;
+
+// Status stream period requested from the Pico, and how often the
+// subscription is renewed (must be well inside LINK_TIMEOUT_MS)
+#define STATUS_STREAM_MS   200
+#define SUBSCRIBE_RENEW_MS 1000
+#define SUBSCRIBE_RETRY_MS 500
+unsigned long lastSubscribe = 0;
+
+void sendLine(const char *line);
+
+extern CommandChannel commands;
+
+void onStatusFrame() {
+    picoBrew.set(picoBrew.connected, true, BF_CONNECTED);
+    commands.onStatus();
+    picoBrew.lastUpdate = millis();
+    picoBrew.rxMicros = lastRxMicros.load(std::memory_order_relaxed);
+    picoBrew.seq++;
+
+    if (PICO_PREFER_BINARY && !binaryRequested) {
+        sendLine(PicoProto::FORMAT_BINARY);
+        binaryRequested = true;
+    }
 }
 
-void jsonString(const String& json, const char* key, char* out, int maxLen) {
-    String search = String("\"") + key + "\":\"";
-    int idx = json.indexOf(search);
-    if (idx == -1) { out[0] = '\0'; return; }
-    idx += search.length();
-    int end = json.indexOf("\"", idx);
-    if (end == -1) { out[0] = '\0'; return; }
-    String val = json.substring(idx, end);
-    val.toCharArray(out, maxLen);
+bool parseBrewJson(const char *json, size_t len) {
+    PROF_SCOPE(PARSE);
+    if (BrewJson::parse(json, len, picoBrew) == 0) return false;
+    onStatusFrame();
+    return true;
 }
 
-void parseBrewJson(const String& json) {
-    brew.temp       = jsonFloat(json, "temp");
-    brew.tempF      = jsonFloat(json, "tempF");
-    brew.target     = jsonFloat(json, "target");
-    brew.flow       = jsonFloat(json, "flow");
-    brew.volume     = jsonFloat(json, "volume");
-    brew.step       = jsonInt(json, "step");
-    brew.stepElapsed = jsonInt(json, "stepElapsed");
-    brew.stepTime   = jsonInt(json, "stepTime");
-    brew.pump       = jsonBool(json, "pump");
-    brew.boiler     = jsonBool(json, "boiler");
-    brew.solenoid   = jsonBool(json, "solenoid");
-    brew.warmer     = jsonBool(json, "warmer");
-    brew.tempRate   = jsonFloat(json, "tempRate");
-    jsonString(json, "state", brew.state, 16);
-    brew.connected  = true;
-    brew.lastUpdate = millis();
+bool parseBrewBinary(const uint8_t *frame, size_t len) {
+    PROF_SCOPE(PARSE);
+    uint16_t ackSeq;
+    if (PicoProto::decodeAck(frame, len, ackSeq)) {
+        commands.onAck(ackSeq, millis());
+        return false;
+    }
+    if (!PicoProto::decode(frame, len, picoBrew)) {
+        uartRx.noteBadFrame();
+        return false;
+    }
+    onStatusFrame();
+    return true;
 }
 
-void updateUART() {
-    while (PicoSerial.available()) {
-        char c = PicoSerial.read();
-        if (c == '\n') {
-            uartBuffer.trim();
-            if (uartBuffer.startsWith("{") && uartBuffer.endsWith("}")) {
-                parseBrewJson(uartBuffer);
-            }
-            uartBuffer = "";
-        } else if (c >= 32 && c < 127) {
-            uartBuffer += c;
-            if (uartBuffer.length() > 1024) {
-                uartBuffer = "";
+// Returns the number of status frames applied
+int updateUART() {
+    PROF_SCOPE(UART);
+    int applied = 0;
+    RxSpan line;
+    while (uartRx.peek(line)) {
+        if (line.binary) {
+            if (parseBrewBinary((const uint8_t *)line.data, line.len)) applied++;
+            uartRx.release();
+            continue;
+        }
+
+        // Trim surrounding spaces, then require a {...} object
+        const char *start = line.data;
+        const char *end = line.data + line.len;
+        while (start < end && *start == ' ') start++;
+        while (end > start && *(end - 1) == ' ') end--;
+        if (end - start >= 2 && *start == '{' && *(end - 1) == '}') {
+            uint16_t ackSeq;
+            if (BrewJson::parseAck(start, end - start, ackSeq)) {
+                commands.onAck(ackSeq, millis());
+            } else if (parseBrewJson(start, end - start)) {
+                applied++;
             }
         }
+        uartRx.release();
     }
 
-    if (brew.connected && (millis() - brew.lastUpdate > 3000)) {
-        brew.connected = false;
+    UartRxStats st = uartRx.stats();
+    if (st.dropped != uartRxReported.dropped ||
+        st.overlong != uartRxReported.overlong ||
+        st.hwOverruns != uartRxReported.hwOverruns ||
+        st.badFrames != uartRxReported.badFrames) {
+        Serial.printf("[UART] frames=%u dropped=%u overlong=%u hwOverrun=%u badFrame=%u\n",
+                      (unsigned)st.frames, (unsigned)st.dropped,
+                      (unsigned)st.overlong, (unsigned)st.hwOverruns,
+                      (unsigned)st.badFrames);
+        uartRxReported = st;
     }
+
+    if (picoBrew.connected && (millis() - picoBrew.lastUpdate > PicoProto::LINK_TIMEOUT_MS)) {
+        picoBrew.set(picoBrew.connected, false, BF_CONNECTED);
+        binaryRequested = false;  // Pico may have rebooted into JSON mode
+        commands.reset();
+    }
+
+    return applied;
 }
 
 // ===================== COMMANDS TO PICO =====================
 
-void sendCmd(char cmd) {
-    PicoSerial.write(cmd);
+// When the last tap was dispatched, for tap -> command latency (0 = none)
+uint32_t tapMicros = 0;
+#define TAP_LATENCY_WINDOW_US 1000000
+
+// Protocol task only: sequencing, acks, retries and coalescing
+CommandChannel commands(PicoSerial, Serial);
+
+// Called from the UI; the protocol task does the actual write
+void sendCmd(char op, int16_t arg = 0) {
+    if (tapMicros) {
+        uint32_t now = Prof::micros32();
+        if (now - tapMicros < TAP_LATENCY_WINDOW_US) Prof::recordSpan(Prof::LAT_CMD, tapMicros, now);
+        tapMicros = 0;
+    }
+    PicoCommand cmd;
+    cmd.op = op;
+    cmd.arg = arg;
+    if (!cmdQueue.push(cmd)) {
+        Serial.printf("[HMI->Pico] queue full, dropped %c\n", op);
+    }
+    if (protocolTaskHandle) xTaskNotifyGive(protocolTaskHandle);
+}
+
+// Optimistic target: a tap shows the new target at once. Status frames
+// still carrying the old one don't undo it; the hold ends when the Pico
+// reports the new target, or after TARGET_HOLD_MS (command lost or the
+// Pico clamped it), and from then on the Pico's value shows again.
+#define TARGET_HOLD_MS (CommandChannel::MAX_DELIVERY_MS + 2 * STATUS_STREAM_MS)
+bool targetHeld = false;
+int16_t heldTarget = 0;
+unsigned long targetHeldSince = 0;
+
+void adjustTarget(int8_t dir) {
+    const int16_t delta = dir * CommandChannel::TARGET_STEP_C;
+    heldTarget = (int16_t)(brew.target + delta * 10);
+    targetHeld = true;
+    targetHeldSince = millis();
+    brew.set(brew.target, heldTarget, BF_TARGET);  // The tap's redraw shows it
+    sendCmd(PicoProto::OP_TARGET, delta);
+}
+
+void sendLine(const char *line) {
+    PicoSerial.print(line);
     PicoSerial.write('\n');
-    Serial.printf("[HMI->Pico] %c\n", cmd);
+    Serial.printf("[HMI->Pico] %s\n", line);
+}
+
+void sendSubscribe() {
+    char line[12];
+    snprintf(line, sizeof(line), "%c%d", PicoProto::SUBSCRIBE, STATUS_STREAM_MS);
+    sendLine(line);
+    lastSubscribe = millis();
+}
+
+// Keep the subscription alive; retry faster while the link is down
+void maintainSubscription(unsigned long now) {
+    unsigned long interval = picoBrew.connected ? SUBSCRIBE_RENEW_MS : SUBSCRIBE_RETRY_MS;
+    if (now - lastSubscribe > interval) {
+        sendSubscribe();
+    }
+}
+
+// ===================== PROTOCOL TASK (core 0) =====================
+
+void protocolTask(void *) {
+    sendSubscribe();
+
+    for (;;) {
+        updateUART();
+
+        const unsigned long now = millis();
+        PicoCommand cmd;
+        while (cmdQueue.pop(cmd)) commands.submit(cmd, now);
+        commands.poll(now);
+
+        maintainSubscription(now);
+
+        // Publish only real changes; the UI wakes to redraw them
+        if (picoBrew.dirty) {
+            picoBrew.dirty = 0;
+            statusChannel.write(picoBrew);
+            if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PROTOCOL_TICK_MS));
+    }
+}
+
+// Temp, flow and volume are shown through StatusFilter, animated between
+// frames (unless BREW_SMOOTHING=0); latest keeps the samples themselves
+// for the history and shot log.
+StatusFilter statusFilter;
+
+// UI side: merge the newest snapshot into brew. Returns true if it changed.
+bool pullStatus() {
+    if (statusChannel.version() == statusVersionSeen) return false;
+    BrewStatus &snap = latest;
+    statusVersionSeen = statusChannel.read(snap);
+    const unsigned long now = millis();
+    if (targetHeld) {
+        if (snap.target == heldTarget || now - targetHeldSince > TARGET_HOLD_MS) {
+            targetHeld = false;
+        } else {
+            snap.target = heldTarget;
+        }
+    }
+#if BREW_SMOOTHING
+    statusFilter.sample(snap, now);
+    BrewStatus shown = snap;
+    statusFilter.update(shown, now);
+    brew.mergeFrom(shown);
+#else
+    brew.mergeFrom(snap);
+#endif
+    return brew.dirty != 0;
+}
+
+// ===================== SHOT HISTORY =====================
+// Fixed-rate samples for the graph screen; a new program (step leaving 0)
+// starts a fresh history.
+
+GraphScreen::History history;
+unsigned long lastSampleMs = 0;
+int lastSampleStep = 0;
+
+void sampleHistory(unsigned long now) {
+    if (now - lastSampleMs < GraphScreen::SAMPLE_MS) return;
+    lastSampleMs = now;
+
+    if (lastSampleStep == 0 && latest.step != 0) history.clear();
+    lastSampleStep = latest.step;
+    history.push({ latest.temp, latest.flow, latest.volume, latest.tempRate });
+}
+
+// ===================== SHOT LOG =====================
+// A shot is saved when state moves to DONE. The UI only copies the history
+// into ShotLog's staging record; a low-priority task on core 0 mounts
+// LittleFS at boot and does every flash write.
+
+#define SHOTLOG_STACK    4096
+#define SHOTLOG_PRIORITY 1      // Below the protocol task
+#define NET_STACK        6144
+#define NET_PRIORITY     1
+
+ShotLog shotLog;
+TaskHandle_t shotLogTaskHandle = nullptr;
+bool lastStateDone = false;
+
+void shotLogTask(void *) {
+    if (!shotLog.mount(Serial)) {
+        shotLogTaskHandle = nullptr;
+        vTaskDelete(nullptr);
+        return;
+    }
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        shotLog.flush(Serial);
+    }
+}
+
+#if BREW_NET
+NetBridge netBridge(statusChannel, Serial);
+#endif
+#if BREW_OTA
+OtaUpdate ota(statusChannel, Serial);
+int8_t otaShown = -1;
+#endif
+
+void logShot(unsigned long now) {
+    const bool done = strcmp(brew.state, "DONE") == 0;
+    if (done && !lastStateDone) {
+#if BREW_NET
+        netBridge.queueShot(NetBridge::summarize(history, GraphScreen::SAMPLE_MS,
+                                                 shotLog.count(), brew.target, latest.volume));
+#endif
+        if (shotLog.stage(history, GraphScreen::SAMPLE_MS, brew.target, now)) {
+            if (shotLogTaskHandle) xTaskNotifyGive(shotLogTaskHandle);
+        } else if (shotLog.ready()) {
+            Serial.println("[ShotLog] previous shot still being written, skipped");
+        }
+    }
+    lastStateDone = done;
+}
+
+// Console: the newest shot as CSV
+void dumpLastShot(Print &out) {
+    static ShotLog::Record rec;  // 2 KB: keep off the stack
+    const uint32_t n = shotLog.count();
+    out.printf("# %u shots logged, %u kept\n", (unsigned)n, (unsigned)(n - shotLog.first()));
+    if (n == 0 || !shotLog.read(n - 1, rec)) return;
+
+    out.printf("# shot %u, %u s, target %d, every %u ms\n", (unsigned)rec.shot,
+               (unsigned)rec.durationS, rec.target, (unsigned)rec.sampleMs);
+    out.println("ms,temp,flow,volume,tempRate");
+    for (uint16_t i = 0; i < rec.count; i++) {
+        const TelemetrySample &t = rec.samples[i];
+        out.printf("%u,%d,%d,%d,%d\n", (unsigned)(i * rec.sampleMs),
+                   t.temp, t.flow, t.volume, t.tempRate);
+    }
 }
 
 // ===================== TOUCH HANDLING =====================
 
-void handleTouch() {
-    bool pressed = touch.touched();
-    unsigned long now = millis();
+bool swallowGesture = false;  // Touch woke the screen; ignore it until release
+
+// Panel events first, then (soak builds) injected ones, already in screen
+// coordinates
+bool nextTouch(TouchEvent &ev, bool &mapped) {
+    mapped = false;
+    if (touchInput.next(ev)) return true;
+#if BREW_SOAK
+    mapped = true;
+    return Soak::next(ev);
+#else
+    return false;
+#endif
+}
+
+// Drain queued touch events. Returns true if any reached a screen.
+bool handleTouch() {
+    bool handled = false;
+    if (calScreen && calScreen->isCalibrating()) return false;  // It reads the panel
 
-    if (pressed && !touchWasPressed && (now - lastTouchTime > TOUCH_DEBOUNCE_MS)) {
-        TS_Point p = touch.getPoint();
+    PROF_SCOPE(TOUCH);
+    touchInput.poll(millis(), !compositor.busy());
+
+    TouchEvent ev;
+    bool mapped;
+    while (nextTouch(ev, mapped)) {
+        if (ev.type == TouchEventType::RELEASE) {
+            swallowGesture = false;
+            continue;
+        }
+        if (ev.type == TouchEventType::PRESS && !pacer.noteTouch(ev.ms)) {
+            swallowGesture = true;  // Dark screen: this tap only wakes it
+            handled = true;
+            continue;
+        }
+        if (swallowGesture) continue;
+        pacer.noteActivity(ev.ms);
 
-        if (p.z > TOUCH_PRESSURE_MIN) {
-            ScreenPoint sp = mapTouch(p.x, p.y);
-            Serial.printf("Touch at (%d,%d) raw(%d,%d) z=%d\n",
-                          sp.x, sp.y, p.x, p.y, p.z);
+        ScreenPoint sp = mapped ? ScreenPoint{ ev.rawX, ev.rawY } : mapTouch(ev.rawX, ev.rawY);
 
-            screenMgr.handleTouch(sp.x, sp.y);
-            lastTouchTime = now;
+        if (ev.type == TouchEventType::PRESS) {
+            Serial.printf("Touch at (%d,%d) raw(%d,%d)\n",
+                          sp.x, sp.y, ev.rawX, ev.rawY);
+        } else if (!brewScreen || !brewScreen->acceptsRepeat(sp.x, sp.y)) {
+            continue;  // Long press / repeat only ramps the temp buttons
         }
+
+        tapMicros = Prof::micros32();
+        screenMgr.handleTouch(sp.x, sp.y);
+        if (brewScreen) brewScreen->noteTouch(ev.ms);
+        if (graphScreen) graphScreen->noteTouch(ev.ms);
+        handled = true;
     }
+    return handled;
+}
+
+// ===================== PROFILING =====================
+// Section timings come from PROF_SCOPE hooks; rx -> pixel latency ends
+// when the frame carrying a status change has left the SPI bus.
+
+uint32_t pixelStartUs = 0;     // Status change waiting to be submitted
+uint32_t pixelInFlightUs = 0;  // ...already in the frame being sent
 
-    touchWasPressed = pressed;
+#define PROFILER_OVERLAY_MS 500
+unsigned long lastOverlayRefresh = 0;
+
+void pixelsSent() {
+    if (!pixelInFlightUs) return;
+    Prof::recordSpan(Prof::LAT_PIXEL, pixelInFlightUs, Prof::micros32());
+    pixelInFlightUs = 0;
 }
 
-// ===================== SETUP =====================
+void drawScreens() {
+    bool wasBusy = compositor.busy();
+    {
+        PROF_SCOPE(DRAW);
+        screenMgr.draw();
+    }
+    if (!pixelStartUs) return;
+
+    if (!wasBusy && compositor.busy()) {
+        // Submitted a frame; it finishes in the frame-complete callback
+        pixelInFlightUs = pixelStartUs;
+        pixelStartUs = 0;
+    } else if (!compositor.isReady()) {
+        // Direct drawing: the pixels are already out
+        pixelInFlightUs = pixelStartUs;
+        pixelStartUs = 0;
+        pixelsSent();
+    }
+}
 
-void setup() {
-    Serial.begin(115200);
-    delay(500);
-    Serial.println("\n=== BrewForge HMI (ForgeUI) ===");
+// "name    p50/p99" in microseconds, two metrics per overlay line
+void formatMetric(FixedFmt::TextBuf &out, Prof::Metric m) {
+    const Prof::Histogram &h = Prof::hist[m];
+    size_t len = strlen(Prof::NAMES[m]);
+    out.put(Prof::NAMES[m]).pad(len < 8 ? 8 - len : 1)
+       .integer(FixedFmt::roundDiv(h.percentile(50), 1000), 5).put('/')
+       .integer(FixedFmt::roundDiv(h.percentile(99), 1000));
+}
 
-    // Backlight off during init
-    pinMode(TFT_BL, OUTPUT);
-    digitalWrite(TFT_BL, LOW);
+void refreshProfilerOverlay(unsigned long now) {
+    if (!brewScreen || !brewScreen->overlayVisible()) return;
+    if (now - lastOverlayRefresh < PROFILER_OVERLAY_MS) return;
+    lastOverlayRefresh = now;
+
+    static const Prof::Metric LINES[BrewScreen::OVERLAY_LINES][2] = {
+        { Prof::UART,      Prof::PARSE },
+        { Prof::TOUCH,     Prof::UPDATE },
+        { Prof::DRAW,      Prof::METRIC_COUNT },
+        { Prof::LAT_PIXEL, Prof::LAT_CMD },
+    };
+    for (uint8_t i = 0; i < BrewScreen::OVERLAY_LINES; i++) {
+        char line[48];
+        FixedFmt::TextBuf out(line, sizeof(line));
+        formatMetric(out, LINES[i][0]);
+        if (LINES[i][1] != Prof::METRIC_COUNT) {
+            out.put("  ");
+            formatMetric(out, LINES[i][1]);
+        } else {
+            out.put("  p50/p99 us");
+        }
+        brewScreen->setOverlayLine(i, line);
+    }
+}
 
-    // Display init
+// ===================== DEBUG CONSOLE =====================
+// Single-character commands on the USB serial port:
+//   p  toggle the profiler overlay
+//   c  dump profiler histograms as CSV
+//   z  reset profiler histograms
+//   s  forget the tested SPI clock (re-test on next boot)
+//   l  dump the newest logged shot as CSV
+//   b  run the hot-path benchmark (esp32dev-bench builds only)
+//   T  inject a tap, "T<x>,<y>[,<holdMs>]" (esp32dev-soak builds only)
+
+void handleConsole() {
+    while (Serial.available() > 0) {
+        switch (Serial.read()) {
+            case 'p':
+                if (brewScreen) {
+                    brewScreen->setOverlayVisible(!brewScreen->overlayVisible());
+                    lastOverlayRefresh = 0;
+                }
+                break;
+            case 'c':
+                Prof::dumpCsv(Serial);
+                break;
+            case 'z':
+                Prof::resetAll();
+                Serial.println("Profiler reset");
+                break;
+            case 's':
+                PanelClock::forget();
+                Serial.println("SPI clock re-test on next boot");
+                break;
+            case 'l':
+                dumpLastShot(Serial);
+                break;
+#if BREW_BENCH
+            case 'b':
+                Bench::run(Serial, tft, theme);
+                break;
+#endif
+#if BREW_SOAK
+            case 'T':
+                Soak::readTap(Serial, millis());
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+}
+
+#if BREW_SOAK
+// ===================== SOAK TEST =====================
+// Injected taps and the periodic [SOAK] line (include/Soak.h). The host's
+// Pico stand-in changes some field in every frame, so every frame is
+// published and the age of `latest` is the time since the UI last got one.
+// Latency is per report: its histogram restarts after each line.
+
+unsigned long lastSoakReport = 0;
+uint32_t soakStaleMaxMs = 0;
+
+void soakPoll(unsigned long now) {
+    Soak::poll(now);
+
+    const int32_t age = (int32_t)(now - latest.lastUpdate);
+    if (brew.connected && age > (int32_t)soakStaleMaxMs) soakStaleMaxMs = age;
+
+    if (now - lastSoakReport < Soak::REPORT_MS) return;
+    lastSoakReport = now;
+
+    const UartRxStats rx = uartRx.stats();  // Written on core 0; each counter reads whole
+    Prof::Histogram &lat = Prof::hist[Prof::LAT_PIXEL];
+    Soak::Sample s;
+    s.uptimeS = now / 1000;
+    s.applied = latest.seq;
+    s.rxFrames = rx.frames;
+    s.rxDropped = rx.dropped;
+    s.rxOverlong = rx.overlong;
+    s.rxHwOverruns = rx.hwOverruns;
+    s.rxBadFrames = rx.badFrames;
+    s.staleMaxMs = soakStaleMaxMs;
+    s.connected = brew.connected;
+    s.latP50Us = lat.percentile(50) / 1000;
+    s.latP99Us = lat.percentile(99) / 1000;
+    s.latMaxUs = lat.max() / 1000;
+    s.stackProtocol = protocolTaskHandle ? uxTaskGetStackHighWaterMark(protocolTaskHandle) : 0;
+    s.stackLoop = uxTaskGetStackHighWaterMark(nullptr);
+    Soak::print(Serial, s);
+
+    lat.reset();
+    soakStaleMaxMs = 0;
+}
+#endif
+
+// ===================== BOOT =====================
+// setup() starts the Pico link first, then resets and tests the panel on
+// core 0 while core 1 loads the touch calibration and builds the screens.
+// The splash stays up only until the first status frame (or SPLASH_MAX_MS).
+
+#define PANEL_INIT_STACK    4096
+#define PANEL_INIT_PRIORITY 1      // Below the protocol task
+#define SPLASH_MAX_MS       3000   // Show the brew screen even without a Pico
+
+SemaphoreHandle_t panelReady = nullptr;
+unsigned long splashShownMs = 0;
+bool bootFramePending = true;     // Waiting for the first frame on the panel
+unsigned long firstFrameMs = 0;
+bool bootConfirmed = false;
+
+// With bootloader rollback, keep a freshly updated image pending until the
+// UI has been up for a while (BootConfirm in OtaUpdate.h) instead of the
+// core marking it valid before setup()
+bool verifyRollbackLater() { return true; }
+
+// Core 0, one shot: TFT_eSPI's reset and init sequence sleep for ~300 ms
+void panelInitTask(void *) {
     tft.init();
     tft.setRotation(0);
     tft.fillScreen(TFT_BLACK);
-    delay(120);
+    BootTrace::mark("panel init");
 
-    // Backlight on
-    digitalWrite(TFT_BL, HIGH);
+    // Fastest write clock this panel reads back cleanly (before initDMA)
+    PanelClock::select(tft, Serial);
+    BootTrace::mark("SPI clock selected");
+
+    xSemaphoreGive(panelReady);
+    vTaskDelete(nullptr);
+}
 
-    // Splash
+void drawSplash() {
     tft.setTextSize(3);
     tft.setTextColor(TFT_CYAN, TFT_BLACK);
     tft.setCursor(15, 80);
@@ -252,83 +735,213 @@ void setup() {
     tft.setCursor(30, 155);
     tft.print("Powered by ForgeUI");
     tft.setCursor(30, 170);
-    tft.print("Initializing touch...");
+    tft.print("Waiting for Pico...");
+}
 
-    // Touch init - SEPARATE SPI bus
-    SPI.begin(TOUCH_CLK, TOUCH_MISO, TOUCH_MOSI, TOUCH_CS);
-    touch.begin();
-    touch.setRotation(0);
-    Serial.println("Touch initialized (VSPI: CLK=25 MISO=39 MOSI=32 CS=33 IRQ=36)");
+// Leave the splash once a status frame is in. Returns true when the brew
+// screen is showing.
+bool finishBoot(unsigned long now) {
+    if (screenMgr.currentScreen() >= 0) return true;
+
+    bool gotStatus = statusChannel.version() != 0;
+    if (!gotStatus && now - splashShownMs < SPLASH_MAX_MS) return false;
+
+    BootTrace::mark(gotStatus ? "first status frame" : "no Pico yet, splash timed out");
+    screenMgr.showScreen(brewScreenIdx);
+    return true;
+}
 
-    tft.setCursor(30, 185);
-    tft.print("Touch OK");
+// ===================== SETUP =====================
 
-    // UART to Pico
+void setup() {
+    Serial.begin(115200);
+    BootTrace::mark("setup");
+    Serial.println("\n=== BrewForge HMI (ForgeUI) ===");
+    BootConfirm::begin(Serial);
+
+    // Backlight off during init
+    pacer.begin(TFT_BL);
+
+    // UART to Pico, and the protocol task so the handshake starts now.
+    // Protocol on core 0; this loop (Arduino's loopTask) stays on core 1
+    // and owns the screens.
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    PicoSerial.setRxBufferSize(UART_DRIVER_RX_BUF);
     PicoSerial.begin(PICO_BAUD, SERIAL_8N1, PICO_RX, PICO_TX);
+    PicoSerial.onReceiveError(onPicoReceiveError);
+    PicoSerial.onReceive(onPicoReceive);
+    xTaskCreatePinnedToCore(protocolTask, "protocol", PROTOCOL_STACK, nullptr,
+                            PROTOCOL_PRIORITY, &protocolTaskHandle, PROTOCOL_CORE);
     Serial.println("Pico UART ready (RX=16 TX=17)");
+    BootTrace::mark("Pico link up");
+
+    // Display reset/init in the background
+    panelReady = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(panelInitTask, "panelinit", PANEL_INIT_STACK, nullptr,
+                            PANEL_INIT_PRIORITY, nullptr, PROTOCOL_CORE);
 
-    tft.setCursor(30, 200);
-    tft.print("UART OK");
+    // Shot log: mounting LittleFS can take seconds on first boot, keep it off this path
+    xTaskCreatePinnedToCore(shotLogTask, "shotlog", SHOTLOG_STACK, nullptr,
+                            SHOTLOG_PRIORITY, &shotLogTaskHandle, PROTOCOL_CORE);
 
-    delay(1500);
+#if BREW_OTA
+    netBridge.attachOta(ota);
+#endif
+#if BREW_NET
+    xTaskCreatePinnedToCore([](void *) { netBridge.run(); }, "net", NET_STACK, nullptr,
+                            NET_PRIORITY, nullptr, PROTOCOL_CORE);
+#endif
+
+    bool calLoaded = touchCal.load();
+    Serial.println(calLoaded ? "Touch calibration restored from NVS"
+                             : "No stored touch calibration, using defaults");
 
     // ========== CREATE SCREENS ==========
 
     brewScreen = new BrewScreen(gfxDriver, theme, brew);
     brewScreen->setCallbacks(
-        []() { sendCmd('b'); },  // Brew
-        []() { sendCmd('x'); },  // Stop
-        []() { sendCmd('-'); },  // Temp down
-        []() { sendCmd('+'); },  // Temp up
-        []() { screenMgr.deferShowScreen(calScreenIdx); }  // Calibrate
+        []() { sendCmd(PicoProto::OP_BREW); },
+        []() { sendCmd(PicoProto::OP_STOP); },
+        []() { adjustTarget(-1); },  // Temp down
+        []() { adjustTarget(+1); },  // Temp up
+        []() { screenMgr.deferShowScreen(calScreenIdx); },   // Calibrate
+        []() { screenMgr.deferShowScreen(graphScreenIdx); }  // Graph
     );
-    brewScreen->setup();
+    brewScreen->attachPanel(tft);
+    brewScreen->ensureBuilt();  // Widgets and glyphs only touch RAM, so build now
     brewScreenIdx = screenMgr.addScreen(brewScreen);
 
     calScreen = new CalibrationScreen(gfxDriver, theme, touch, touchCal);
     calScreen->setOnComplete([]() {
+        if (!touchCal.save()) Serial.println("Failed to save touch calibration");
+        touchInput.reset();  // Drop anything latched while calibrating
         screenMgr.deferShowScreen(brewScreenIdx);
     });
     calScreen->setup();
     calScreenIdx = screenMgr.addScreen(calScreen);
 
-    // Show brew screen
-    screenMgr.showScreen(brewScreenIdx);
+    graphScreen = new GraphScreen(gfxDriver, theme, tft, panelScroll, history, brew);
+    graphScreen->setOnBack([]() { screenMgr.deferShowScreen(brewScreenIdx); });
+    graphScreenIdx = screenMgr.addScreen(graphScreen);
+
+    screenMgr.setPanelScroll(&panelScroll);
+    BootTrace::mark("screens built");
+
+    // ========== PANEL ==========
+
+    xSemaphoreTake(panelReady, portMAX_DELAY);
+    vSemaphoreDelete(panelReady);
+
+    // Touch init - own pins, but the same global SPIClass as the panel,
+    // hence no touch reads while a frame is in flight (handleTouch()).
+    // Kept after tft.init() as before: the SPI driver keeps whichever pins
+    // it is begun with first.
+    SPI.begin(TOUCH_CLK, TOUCH_MISO, TOUCH_MOSI, TOUCH_CS);
+    touch.begin();
+    touch.setRotation(0);
+    Serial.println("Touch initialized (VSPI: CLK=25 MISO=39 MOSI=32 CS=33 IRQ=36)");
+
+    // Off-screen strip for flicker-free redraws (falls back to direct drawing)
+    if (!compositor.begin()) {
+        Serial.println("Compositor unavailable, drawing directly");
+    }
+    brewScreen->setCompositor(&compositor);
+    compositor.setOnFrameComplete([]() {
+        frameCompleted = true;
+        pixelsSent();
+    });
+
+    drawSplash();
+    pacer.start(millis());
+    splashShownMs = millis();
+    BootTrace::mark("splash");
 
     Serial.println("HMI ready. Waiting for Pico...");
 }
 
 // ===================== MAIN LOOP =====================
 
+// Frames redraw immediately; pacer.tickMs() only paces redraws with no
+// new data (button press feedback, connection timeout)
 unsigned long lastScreenUpdate = 0;
-unsigned long lastStatusRequest = 0;
-#define SCREEN_UPDATE_MS 250
-#define STATUS_REQUEST_MS 500
 
 void loop() {
     unsigned long now = millis();
 
-    // Read UART data from Pico
-    updateUART();
+    // Latest status from the protocol task
+    bool redraw = pullStatus();
+    if (redraw && !pixelStartUs) pixelStartUs = brew.rxMicros;
+#if BREW_SMOOTHING
+    if (statusFilter.update(brew, now)) redraw = true;
+#endif
+    sampleHistory(now);
+    logShot(now);
+
+    // Splash until the first status frame
+    if (!finishBoot(now)) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        return;
+    }
 
     // Handle touch input
-    handleTouch();
+    if (handleTouch()) redraw = true;
 
-    // Process deferred screen switches
-    screenMgr.processDeferredActions();
+    // Process deferred screen switches — never while a frame holds the bus
+    if (!compositor.busy()) {
+        screenMgr.processDeferredActions();
+        screenMgr.reclaim(now);
+    }
 
-    // Periodically request status from Pico
-    if (now - lastStatusRequest > STATUS_REQUEST_MS) {
-        sendCmd('s');
-        lastStatusRequest = now;
+    // Calibration steps its state machine every pass
+    if (calScreen && calScreen->isCalibrating()) {
+        redraw = true;
+        pacer.noteActivity(now);
     }
+    pacer.update(brew, now);
 
     // Update + draw active screen
-    if (now - lastScreenUpdate > SCREEN_UPDATE_MS) {
-        screenMgr.update();
-        screenMgr.draw();
+    if (redraw || now - lastScreenUpdate > pacer.tickMs()) {
+        {
+            PROF_SCOPE(UPDATE);
+            screenMgr.update();
+        }
+        drawScreens();
         lastScreenUpdate = now;
+    } else if (frameCompleted) {
+        // Damage that arrived while the last frame was in flight
+        drawScreens();
+    }
+    frameCompleted = false;
+
+    handleConsole();
+    refreshProfilerOverlay(now);
+#if BREW_SOAK
+    soakPoll(now);
+#endif
+
+    // Render/queue the next strips of the frame in flight
+    compositor.pump();
+
+    if (bootFramePending && !compositor.busy() && lastScreenUpdate) {
+        BootTrace::mark("first frame on panel");
+        bootFramePending = false;
+        firstFrameMs = now;
+    }
+    if (!bootConfirmed && !bootFramePending &&
+        now - firstFrameMs > BootConfirm::CONFIRM_AFTER_MS) {
+        BootConfirm::confirm(Serial);
+        bootConfirmed = true;
+    }
+
+#if BREW_OTA
+    // Upload progress from the net task
+    if (ota.progress() != otaShown) {
+        otaShown = ota.progress();
+        brewScreen->setUpdateProgress(otaShown);
     }
+#endif
 
-    delay(10);
+    // Sleep until the protocol task publishes, or 10 ms to check the touch
+    // IRQ latch; just yield while a frame is still being sent
+    ulTaskNotifyTake(pdTRUE, compositor.busy() ? 1 : pdMS_TO_TICKS(10));
 }
@@ -0,0 +1,52 @@
+/**
+ * Arduino.h - Host stand-in for the parts of the Arduino core the tested
+ * headers use (env:native only)
+ *
+ * millis() reads testMillis, which tests set to move time. Serial prints
+ * to stdout; tests capture a link by subclassing Print.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+inline unsigned long testMillis = 0;
+
+inline unsigned long millis() { return testMillis; }
+
+// The printing half of the core's Print; subclasses supply write()
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+
+    size_t write(const uint8_t *buf, size_t len) {
+        for (size_t i = 0; i < len; i++) write(buf[i]);
+        return len;
+    }
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list args;
+        va_start(args, fmt);
+        const int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n <= 0) return 0;
+        return write((const uint8_t *)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+    }
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t println(const char *s = "") { return print(s) + write('\n'); }
+    void flush() {}
+};
+
+class HostSerial : public Print {
+public:
+    using Print::write;
+    size_t write(uint8_t c) override { return putchar(c) == EOF ? 0 : 1; }
+};
+
+inline HostSerial Serial;
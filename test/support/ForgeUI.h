@@ -0,0 +1,205 @@
+/**
+ * ForgeUI.h - Host stand-in for the ForgeUI library (env:native only)
+ *
+ * The same class names and members the firmware uses, with bodies just
+ * real enough to test against: widgets draw through the GfxDriver in the
+ * obvious way, so a recording driver (MockGfx.h) sees what each redraw
+ * touches. ScreenManager calls onEnter() inside showScreen() and
+ * processDeferredActions(), as the library does.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <vector>
+
+class GfxDriver {
+public:
+    enum Datum { DATUM_TL, DATUM_TC, DATUM_TR, DATUM_ML, DATUM_MC, DATUM_MR };
+
+    virtual ~GfxDriver() {}
+
+    virtual void fillScreen(uint16_t color) = 0;
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+    virtual void setTextSize(uint8_t size) = 0;
+    virtual void setTextColor(uint16_t fg, uint16_t bg) = 0;
+    virtual void setTextDatum(Datum datum) = 0;
+    virtual void drawString(const char *s, int16_t x, int16_t y) = 0;
+    virtual void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color) = 0;
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) = 0;
+};
+
+struct ForgeTheme {
+    int16_t  screenW, screenH;
+    uint16_t bgPrimary, bgHeader;
+    uint16_t accentCyan, accentGreen, accentRed, accentPrimary, accentYellow, accentBlue;
+    uint16_t textDim, textPrimary, btnDefault;
+};
+
+// Distinct colours, so tests can tell which role drew
+inline ForgeTheme forgeThemeDark(int16_t w, int16_t h) {
+    return { w, h, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008,
+             0x0009, 0x000A, 0x000B };
+}
+
+class UIElement {
+public:
+    bool visible = true;
+
+    virtual ~UIElement() {}
+    virtual void draw(GfxDriver &g) = 0;
+    void setVisible(bool v) { visible = v; }
+};
+
+class Label : public UIElement {
+public:
+    int16_t  x, y;
+    uint16_t textColor, bgColor;
+    uint8_t  size;
+    GfxDriver::Datum datum;
+    int16_t  clearW;
+    char     text[64] = {};
+
+    Label(int16_t x, int16_t y, const char *s, uint16_t fg, uint16_t bg, uint8_t size = 1,
+          GfxDriver::Datum datum = GfxDriver::DATUM_TL, int16_t clearW = 0)
+        : x(x), y(y), textColor(fg), bgColor(bg), size(size), datum(datum), clearW(clearW) {
+        setText(s);
+    }
+
+    void setText(const char *s) {
+        strncpy(text, s ? s : "", sizeof(text) - 1);
+    }
+
+    void draw(GfxDriver &g) override {
+        if (clearW > 0) {
+            const int16_t left = datum == GfxDriver::DATUM_TC ? x - clearW / 2
+                               : datum == GfxDriver::DATUM_TR ? x - clearW : x;
+            g.fillRect(left, y, clearW, 8 * size, bgColor);
+        }
+        g.setTextSize(size);
+        g.setTextColor(textColor, bgColor);
+        g.setTextDatum(datum);
+        g.drawString(text, x, y);
+    }
+};
+
+class StatusDot : public UIElement {
+public:
+    int16_t  x, y, r;
+    uint16_t onColor, offColor;
+    char     letter;
+    bool     active = false;
+
+    StatusDot(int16_t x, int16_t y, int16_t r, uint16_t on, uint16_t off, char letter = 0)
+        : x(x), y(y), r(r), onColor(on), offColor(off), letter(letter) {}
+
+    void setActive(bool on) { active = on; }
+
+    void draw(GfxDriver &g) override {
+        g.fillRect(x - r, y - r, 2 * r + 1, 2 * r + 1, active ? onColor : offColor);
+        g.drawCircle(x, y, r, active ? onColor : offColor);
+    }
+};
+
+class ProgressBar : public UIElement {
+public:
+    int16_t  x, y, w, h;
+    uint16_t fillColor, bgColor, borderColor;
+    bool     border;
+    float    progress = 0;
+
+    ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t fill, uint16_t bg,
+                uint16_t borderColor, bool border)
+        : x(x), y(y), w(w), h(h), fillColor(fill), bgColor(bg), borderColor(borderColor),
+          border(border) {}
+
+    void setProgress(float p) { progress = p; }
+
+    void draw(GfxDriver &g) override {
+        const int16_t filled = (int16_t)(w * progress);
+        g.fillRect(x, y, filled, h, fillColor);
+        g.fillRect(x + filled, y, w - filled, h, bgColor);
+    }
+};
+
+class Button : public UIElement {
+public:
+    int16_t  x, y, w, h;
+    uint16_t faceColor, textColor;
+    uint8_t  size;
+    const char *label;
+    bool     pressed = false;
+    std::function<void()> onClick;
+
+    Button(int16_t x, int16_t y, int16_t w, int16_t h, const char *text, uint16_t face,
+           uint16_t caption, uint8_t size)
+        : x(x), y(y), w(w), h(h), faceColor(face), textColor(caption), size(size), label(text) {}
+
+    void updatePressState() {}
+
+    void draw(GfxDriver &g) override {
+        g.fillRect(x, y, w, h, faceColor);
+        g.setTextSize(size);
+        g.setTextColor(textColor, faceColor);
+        g.setTextDatum(GfxDriver::DATUM_MC);
+        g.drawString(label, x + w / 2, y + h / 2);
+    }
+};
+
+class Screen {
+protected:
+    GfxDriver &gfx;
+    const ForgeTheme &theme;
+    std::vector<UIElement *> elements;
+    bool needsRedraw = true;
+    bool firstDraw = true;
+
+public:
+    Screen(GfxDriver &g, const ForgeTheme &t, const char *) : gfx(g), theme(t) {}
+    virtual ~Screen() {}
+
+    void addElement(UIElement *e) { elements.push_back(e); }
+    void setNeedsRedraw() { needsRedraw = true; }
+
+    virtual void setup() = 0;
+    virtual void onEnter() {
+        firstDraw = true;
+        needsRedraw = true;
+    }
+    virtual void update() = 0;
+    virtual void draw() = 0;
+};
+
+class ScreenManager {
+private:
+    std::vector<Screen *> screens;
+    int shown = -1;
+    int deferred = -1;
+
+public:
+    int addScreen(Screen *s) {
+        screens.push_back(s);
+        s->setup();
+        return (int)screens.size() - 1;
+    }
+
+    void showScreen(int idx) {
+        if (idx < 0 || idx >= (int)screens.size()) return;
+        shown = idx;
+        screens[idx]->onEnter();
+    }
+
+    void deferShowScreen(int idx) { deferred = idx; }
+
+    void processDeferredActions() {
+        if (deferred < 0) return;
+        const int idx = deferred;
+        deferred = -1;
+        showScreen(idx);
+    }
+
+    void update() { if (shown >= 0) screens[shown]->update(); }
+    void draw()   { if (shown >= 0) screens[shown]->draw(); }
+};
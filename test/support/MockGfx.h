@@ -0,0 +1,109 @@
+/**
+ * MockGfx.h - GfxDriver that records what a screen draws (env:native only)
+ *
+ * Every fill and string is kept with its position, so a test can check
+ * that a redraw touched only the widgets it should have. reset() between
+ * the steps of a test.
+ *
+ * calls and pixels are counted either way, pixels estimated the same way
+ * as Bench.h's CountingGfx on the device. With recording off nothing is
+ * kept, so a benchmark's allocation count is the screen's own.
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+class MockGfx : public GfxDriver {
+public:
+    struct Area {
+        int16_t x, y, w, h;
+
+        bool overlaps(int16_t ox, int16_t oy, int16_t ow, int16_t oh) const {
+            return x < ox + ow && ox < x + w && y < oy + oh && oy < y + h;
+        }
+    };
+
+    struct Text {
+        std::string s;
+        int16_t x, y;
+    };
+
+    std::vector<Area> fills;   // fillRect, fillScreen and circle bounds
+    std::vector<Text> texts;
+    uint32_t calls = 0;
+    uint32_t pixels = 0;
+    bool recording = true;
+
+    void reset() {
+        fills.clear();
+        texts.clear();
+        calls = 0;
+        pixels = 0;
+    }
+
+    // Anything drawn inside (x, y, w, h)?
+    bool touched(int16_t x, int16_t y, int16_t w, int16_t h) const {
+        for (const Area &a : fills) {
+            if (a.overlaps(x, y, w, h)) return true;
+        }
+        for (const Text &t : texts) {
+            if (t.x >= x && t.x < x + w && t.y >= y && t.y < y + h) return true;
+        }
+        return false;
+    }
+
+    // Was a string containing `s` drawn?
+    bool drew(const char *s) const {
+        for (const Text &t : texts) {
+            if (t.s.find(s) != std::string::npos) return true;
+        }
+        return false;
+    }
+
+    // Characters drawn, across all strings
+    size_t glyphs() const {
+        size_t n = 0;
+        for (const Text &t : texts) n += t.s.size();
+        return n;
+    }
+
+    void fillScreen(uint16_t) override {
+        calls++;
+        pixels += 240 * 320;
+        if (recording) fills.push_back({ 0, 0, 240, 320 });
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t) override {
+        calls++;
+        pixels += (uint32_t)w * h;
+        if (recording) fills.push_back({ x, y, w, h });
+    }
+    void setTextSize(uint8_t s) override { textSize = s; }
+    void setTextColor(uint16_t, uint16_t) override {}
+    void setTextDatum(Datum) override {}
+    void drawString(const char *s, int16_t x, int16_t y) override {
+        calls++;
+        pixels += (uint32_t)strlen(s) * 6 * textSize * 8 * textSize;  // GLCD cells
+        if (recording) texts.push_back({ s, x, y });
+    }
+    void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t) override {
+        calls++;
+        pixels += 6 * r;  // ~circumference
+        if (recording) {
+            fills.push_back({ (int16_t)(x - r), (int16_t)(y - r), (int16_t)(2 * r + 1), (int16_t)(2 * r + 1) });
+        }
+    }
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t) override {
+        calls++;
+        const int16_t w = (int16_t)(abs(x1 - x0) + 1), h = (int16_t)(abs(y1 - y0) + 1);
+        pixels += w > h ? w : h;
+        if (recording) fills.push_back({ x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, w, h });
+    }
+
+private:
+    uint8_t textSize = 1;
+};
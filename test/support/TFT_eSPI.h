@@ -0,0 +1,41 @@
+/**
+ * TFT_eSPI.h - Host stand-in for TFT_eSPI (env:native only)
+ *
+ * Just the calls the tested headers make, all no-ops. Sprites are never
+ * created, so anything that needs pixels (glyph atlases, the compositor)
+ * falls back the way it does on the device when memory runs out.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class TFT_eSPI {
+public:
+    virtual ~TFT_eSPI() {}
+
+    void startWrite() {}
+    void endWrite() {}
+    void setAddrWindow(int32_t, int32_t, int32_t, int32_t) {}
+    void pushColors(uint16_t *, uint32_t, bool = true) {}
+    void pushImage(int32_t, int32_t, int32_t, int32_t, const uint16_t *) {}
+    void pushImageDMA(int32_t, int32_t, int32_t, int32_t, uint16_t *) {}
+    bool initDMA() { return false; }
+    bool dmaBusy() { return false; }
+    void writecommand(uint8_t) {}
+    void writedata(uint8_t) {}
+    void drawChar(int32_t, int32_t, uint16_t, uint32_t, uint32_t, uint8_t) {}
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI *) {}
+
+    void setColorDepth(int8_t) {}
+    void *createSprite(int16_t, int16_t) { return nullptr; }
+    void deleteSprite() {}
+    void *getPointer() { return nullptr; }
+    void fillSprite(uint32_t) {}
+    void setViewport(int32_t, int32_t, int32_t, int32_t) {}
+    void resetViewport() {}
+};
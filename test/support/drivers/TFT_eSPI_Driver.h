@@ -0,0 +1,23 @@
+/**
+ * drivers/TFT_eSPI_Driver.h - Host stand-in for ForgeUI's TFT_eSPI
+ * GfxDriver (env:native only); every call is a no-op
+ */
+
+#pragma once
+
+#include <ForgeUI.h>
+#include <TFT_eSPI.h>
+
+class TFT_eSPI_Driver : public GfxDriver {
+public:
+    explicit TFT_eSPI_Driver(TFT_eSPI &) {}
+
+    void fillScreen(uint16_t) override {}
+    void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) override {}
+    void setTextSize(uint8_t) override {}
+    void setTextColor(uint16_t, uint16_t) override {}
+    void setTextDatum(Datum) override {}
+    void drawString(const char *, int16_t, int16_t) override {}
+    void drawCircle(int16_t, int16_t, int16_t, uint16_t) override {}
+    void drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t) override {}
+};
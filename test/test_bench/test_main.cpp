@@ -0,0 +1,212 @@
+// Replay benchmark of the status -> screen hot path on the host: Pico
+// traffic through UartLineRing, BrewJson / PicoProto and BrewScreen,
+// drawing into MockGfx. Reports frames/s per stage, heap allocations,
+// draw calls and pixels per frame, and fails if decoding drops a frame or
+// the parsers allocate.
+//
+// The input is ShotCapture.h, the same synthetic shot the on-device
+// benchmark (include/Bench.h) replays. A recorded capture can be replayed
+// too: point BREW_CAPTURE at a file of raw Pico UART bytes.
+//
+// Host timings only rank changes against each other; the device numbers
+// still come from env:esp32dev-bench.
+
+#include <unity.h>
+
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "BrewJson.h"
+#include "BrewScreen.h"
+#include "MockGfx.h"
+#include "ShotCapture.h"
+#include "UartRx.h"
+
+// ---- Heap allocation counter ----
+
+static uint32_t heapAllocs = 0;
+
+// glibc's allocator can be replaced outright, which counts operator new
+// and plain malloc alike. Under ASan (or elsewhere) count operator new.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+extern "C" {
+void *__libc_malloc(size_t n);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t n);
+
+void *malloc(size_t n) {
+    heapAllocs++;
+    return __libc_malloc(n);
+}
+void *calloc(size_t n, size_t size) {
+    heapAllocs++;
+    return __libc_calloc(n, size);
+}
+void *realloc(void *p, size_t n) {
+    heapAllocs++;
+    return __libc_realloc(p, n);
+}
+}
+#else
+void *operator new(size_t n) {
+    heapAllocs++;
+    if (void *p = malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t n) { return operator new(n); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+#endif
+
+// ---- Runner ----
+
+static constexpr uint32_t FRAMES = 20000;  // 50 shots
+static constexpr uint32_t FRAME_MS = 50;   // Pico status rate
+
+using Clock = std::chrono::steady_clock;
+using Ring = UartLineRing<4, BrewJson::MAX_FRAME_LEN>;
+
+static const ForgeTheme theme = forgeThemeDark(240, 320);
+static Ring *ring;
+static MockGfx gfx;
+static BrewStatus brew;
+static BrewScreen *screen;
+
+struct Result {
+    Clock::duration parse{}, update{}, draw{};
+    uint32_t frames = 0, allocs = 0, parseAllocs = 0, calls = 0, pixels = 0;
+};
+
+static Result result;
+
+void setUp() {
+    testMillis = 1000;
+    brew = BrewStatus();
+    ring = new Ring();
+    screen = new BrewScreen(gfx, theme, brew);
+    screen->setup();
+    screen->onEnter();
+    screen->update();
+    screen->draw();  // First full draw is not part of the steady state
+
+    gfx.recording = false;
+    gfx.reset();
+    result = Result();
+}
+
+void tearDown() {
+    gfx.recording = true;
+    delete screen;
+    delete ring;
+}
+
+// One chunk of wire bytes through every stage
+static void replay(const uint8_t *wire, size_t n) {
+    const uint32_t allocs0 = heapAllocs;
+    const Clock::time_point t0 = Clock::now();
+    ring->feed(wire, n);
+    RxSpan span;
+    while (ring->peek(span)) {
+        bool ok = span.binary
+            ? PicoProto::decode((const uint8_t *)span.data, span.len, brew)
+            : BrewJson::parse(span.data, span.len, brew) > 0;
+        if (ok) result.frames++;
+        ring->release();
+    }
+    const Clock::time_point t1 = Clock::now();
+    result.parseAllocs += heapAllocs - allocs0;
+    screen->update();
+    const Clock::time_point t2 = Clock::now();
+    screen->draw();
+    const Clock::time_point t3 = Clock::now();
+    result.allocs += heapAllocs - allocs0;
+
+    result.parse += t1 - t0;
+    result.update += t2 - t1;
+    result.draw += t3 - t2;
+    testMillis += FRAME_MS;
+}
+
+static void replayCapture(bool binary) {
+    char wire[BrewJson::MAX_FRAME_LEN];
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        PicoProto::StatusPayload s;
+        ShotCapture::frame(i % ShotCapture::FRAMES_PER_SHOT, s);
+        size_t n = binary ? ShotCapture::encodeBinary(s, (uint8_t *)wire)
+                          : ShotCapture::encodeJson(s, wire, sizeof(wire));
+        replay((const uint8_t *)wire, n);
+    }
+    result.calls = gfx.calls;
+    result.pixels = gfx.pixels;
+}
+
+static void report(const char *name) {
+    const Result &r = result;
+    auto perSec = [&](Clock::duration d) -> double {
+        const double s = std::chrono::duration<double>(d).count();
+        return s > 0 ? r.frames / s : 0;
+    };
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%s: %u frames  parse %.0f/s  update %.0f/s  draw %.0f/s  "
+             "allocs %.2f  draw calls %.1f  pixels %u  (per frame)",
+             name, (unsigned)r.frames, perSec(r.parse), perSec(r.update), perSec(r.draw),
+             r.frames ? (double)r.allocs / r.frames : 0,
+             r.frames ? (double)r.calls / r.frames : 0,
+             (unsigned)(r.frames ? r.pixels / r.frames : 0));
+    TEST_MESSAGE(line);
+}
+
+static void test_json_capture() {
+    replayCapture(false);
+    report("json");
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, result.frames);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, result.parseAllocs, "parsers allocated");
+    TEST_ASSERT_GREATER_THAN_UINT32(0, result.calls);
+}
+
+static void test_binary_capture() {
+    replayCapture(true);
+    report("binary");
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, result.frames);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, result.parseAllocs, "parsers allocated");
+    TEST_ASSERT_GREATER_THAN_UINT32(0, result.calls);
+}
+
+// Raw UART bytes, as a logic analyser or `pio device monitor --raw` saves
+// them, fed in driver-sized chunks
+static void test_recorded_capture() {
+    const char *path = getenv("BREW_CAPTURE");
+    if (!path) TEST_IGNORE_MESSAGE("set BREW_CAPTURE to replay a recorded capture");
+
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[64];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(f);
+
+    for (size_t at = 0; at < bytes.size(); at += sizeof(chunk)) {
+        const size_t len = bytes.size() - at < sizeof(chunk) ? bytes.size() - at : sizeof(chunk);
+        replay(bytes.data() + at, len);
+    }
+    result.calls = gfx.calls;
+    result.pixels = gfx.pixels;
+    report(path);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, result.frames);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, result.parseAllocs, "parsers allocated");
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_json_capture);
+    RUN_TEST(test_binary_capture);
+    RUN_TEST(test_recorded_capture);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+// BrewJson: status lines into BrewStatus, and command acks
+
+#include <unity.h>
+
+#include "BrewJson.h"
+
+static BrewStatus status;
+
+void setUp() {
+    status = BrewStatus();
+    status.dirty = 0;
+}
+
+void tearDown() {}
+
+static int parse(const char *line) { return BrewJson::parse(line, strlen(line), status); }
+
+static void test_full_frame() {
+    const char *line =
+        "{\"temp\":92.4,\"tempF\":198.3,\"target\":93.0,\"state\":\"BREW\",\"step\":3,"
+        "\"stepElapsed\":12,\"stepTime\":30,\"pump\":true,\"boiler\":false,\"solenoid\":true,"
+        "\"warmer\":false,\"flow\":1.8,\"volume\":21.5,\"tempRate\":0.25}";
+    TEST_ASSERT_EQUAL_INT(14, parse(line));
+    TEST_ASSERT_EQUAL_INT16(924, status.temp);
+    TEST_ASSERT_EQUAL_INT16(1983, status.tempF);
+    TEST_ASSERT_EQUAL_INT16(930, status.target);
+    TEST_ASSERT_EQUAL_STRING("BREW", status.state);
+    TEST_ASSERT_EQUAL_INT(3, status.step);
+    TEST_ASSERT_EQUAL_INT(12, status.stepElapsed);
+    TEST_ASSERT_EQUAL_INT(30, status.stepTime);
+    TEST_ASSERT_TRUE(status.pump);
+    TEST_ASSERT_FALSE(status.boiler);
+    TEST_ASSERT_TRUE(status.solenoid);
+    TEST_ASSERT_FALSE(status.warmer);
+    TEST_ASSERT_EQUAL_INT16(18, status.flow);
+    TEST_ASSERT_EQUAL_INT16(215, status.volume);
+    TEST_ASSERT_EQUAL_INT16(25, status.tempRate);
+}
+
+static void test_decimals_scale_and_round() {
+    parse("{\"temp\":92,\"flow\":0.05,\"target\":92.44,\"tempRate\":-1.5,\"volume\":-0.3}");
+    TEST_ASSERT_EQUAL_INT16(920, status.temp);
+    TEST_ASSERT_EQUAL_INT16(1, status.flow);      // Rounded on the next digit
+    TEST_ASSERT_EQUAL_INT16(924, status.target);
+    TEST_ASSERT_EQUAL_INT16(-150, status.tempRate);
+    TEST_ASSERT_EQUAL_INT16(-3, status.volume);
+}
+
+static void test_dirty_bits_only_for_changes() {
+    parse("{\"temp\":92.4,\"step\":3}");
+    TEST_ASSERT_EQUAL_HEX16(BF_TEMP | BF_STEP, status.takeDirty());
+
+    parse("{\"temp\":92.4,\"step\":3}");
+    TEST_ASSERT_EQUAL_HEX16(0, status.takeDirty());
+
+    parse("{\"temp\":92.5,\"step\":3}");
+    TEST_ASSERT_EQUAL_HEX16(BF_TEMP, status.takeDirty());
+}
+
+static void test_missing_keys_keep_values() {
+    parse("{\"temp\":50.0,\"target\":90.0}");
+    parse("{\"temp\":51.0}");
+    TEST_ASSERT_EQUAL_INT16(510, status.temp);
+    TEST_ASSERT_EQUAL_INT16(900, status.target);
+}
+
+static void test_unknown_keys_skipped() {
+    TEST_ASSERT_EQUAL_INT(2, parse("{\"fw\":\"1,2}\",\"temp\":40.0,\"uptime\":12345,"
+                                   "\"ok\":true,\"step\":1}"));
+    TEST_ASSERT_EQUAL_INT16(400, status.temp);
+    TEST_ASSERT_EQUAL_INT(1, status.step);
+}
+
+static void test_whitespace() {
+    TEST_ASSERT_EQUAL_INT(2, parse("  { \"temp\" : 40.0 , \"state\" : \"IDLE\" }"));
+    TEST_ASSERT_EQUAL_INT16(400, status.temp);
+    TEST_ASSERT_EQUAL_STRING("IDLE", status.state);
+}
+
+static void test_state_truncated_to_field() {
+    parse("{\"state\":\"A_VERY_LONG_STATE_NAME\"}");
+    TEST_ASSERT_EQUAL_UINT(sizeof(status.state) - 1, strlen(status.state));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(status.state, "A_VERY_LONG_STATE_NAME", sizeof(status.state) - 1));
+}
+
+static void test_not_a_status_frame() {
+    TEST_ASSERT_EQUAL_INT(0, parse(""));
+    TEST_ASSERT_EQUAL_INT(0, parse("hello"));
+    TEST_ASSERT_EQUAL_INT(0, parse("[1,2,3]"));
+    TEST_ASSERT_EQUAL_HEX16(0, status.dirty);
+}
+
+static void test_malformed_keeps_earlier_fields() {
+    TEST_ASSERT_EQUAL_INT(1, parse("{\"temp\":61.0,garbage"));
+    TEST_ASSERT_EQUAL_INT16(610, status.temp);
+    TEST_ASSERT_EQUAL_INT(1, parse("{\"temp\":62.0,\"target"));
+    TEST_ASSERT_EQUAL_INT16(620, status.temp);
+}
+
+static void test_overlong_rejected() {
+    static char line[BrewJson::MAX_FRAME_LEN + 16];
+    memset(line, ' ', sizeof(line));
+    memcpy(line, "{\"temp\":70.0}", 13);
+    TEST_ASSERT_EQUAL_INT(0, BrewJson::parse(line, sizeof(line), status));
+    TEST_ASSERT_EQUAL_INT16(0, status.temp);
+}
+
+static void test_ack() {
+    uint16_t seq = 0;
+    TEST_ASSERT_TRUE(BrewJson::parseAck("{\"ack\":17}", 10, seq));
+    TEST_ASSERT_EQUAL_UINT16(17, seq);
+    TEST_ASSERT_TRUE(BrewJson::parseAck(" { \"ack\" : 65535 }", 18, seq));
+    TEST_ASSERT_EQUAL_UINT16(65535, seq);
+}
+
+static void test_ack_rejects_others() {
+    uint16_t seq = 5;
+    const char *bad[] = { "{\"ack\":0}", "{\"ack\":65536}", "{\"ack\":-1}", "{\"temp\":1}",
+                          "{\"ack\":\"x\"}", "ack:3" };
+    for (const char *s : bad) TEST_ASSERT_FALSE(BrewJson::parseAck(s, strlen(s), seq));
+    TEST_ASSERT_EQUAL_UINT16(5, seq);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_frame);
+    RUN_TEST(test_decimals_scale_and_round);
+    RUN_TEST(test_dirty_bits_only_for_changes);
+    RUN_TEST(test_missing_keys_keep_values);
+    RUN_TEST(test_unknown_keys_skipped);
+    RUN_TEST(test_whitespace);
+    RUN_TEST(test_state_truncated_to_field);
+    RUN_TEST(test_not_a_status_frame);
+    RUN_TEST(test_malformed_keeps_earlier_fields);
+    RUN_TEST(test_overlong_rejected);
+    RUN_TEST(test_ack);
+    RUN_TEST(test_ack_rejects_others);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+// BrewScreen::update() / draw() against a recording GfxDriver: each
+// changed field redraws its own widgets and nothing else
+
+#include <unity.h>
+
+#include "BrewScreen.h"
+#include "MockGfx.h"
+
+using namespace BrewLayout;
+
+static const ForgeTheme theme = forgeThemeDark(240, 320);
+static MockGfx gfx;
+static BrewStatus brew;
+static BrewScreen *screen;
+
+static void frame() {
+    gfx.reset();
+    screen->update();
+    screen->draw();
+}
+
+void setUp() {
+    testMillis = 1000;
+    brew = BrewStatus();
+    brew.temp = 924;
+    screen = new BrewScreen(gfx, theme, brew);
+    screen->setup();
+    screen->onEnter();
+    frame();
+    gfx.reset();
+}
+
+void tearDown() {
+    delete screen;
+    screen = nullptr;
+}
+
+// Rows [y0, y1) across the whole screen
+static bool rowsTouched(int16_t y0, int16_t y1) { return gfx.touched(0, y0, SCREEN_W, y1 - y0); }
+
+static void test_first_draw_paints_everything() {
+    screen->onEnter();
+    frame();
+    TEST_ASSERT_TRUE(gfx.touched(0, 0, 1, 1));  // fillScreen
+    TEST_ASSERT_TRUE(gfx.drew("BrewForge"));
+    TEST_ASSERT_TRUE(gfx.drew("BREW"));
+    TEST_ASSERT_TRUE(gfx.drew("GRAPH"));
+    TEST_ASSERT_TRUE(gfx.drew("[0]IDLE"));
+}
+
+static void test_idle_draws_nothing() {
+    for (int i = 0; i < 5; i++) {
+        testMillis += 200;
+        frame();
+        TEST_ASSERT_EQUAL_UINT32(0, gfx.calls);
+    }
+}
+
+static void test_unchanged_frame_draws_nothing() {
+    // A status frame that repeats every value sets no dirty bits
+    brew.set(brew.temp, (int16_t)924, (uint16_t)BF_TEMP);
+    brew.setState("IDLE", 4);
+    frame();
+    TEST_ASSERT_EQUAL_UINT32(0, gfx.calls);
+}
+
+static void test_temp_redraws_changed_cells_only() {
+    brew.set(brew.temp, (int16_t)925, (uint16_t)BF_TEMP);  // 92.4 -> 92.5
+    frame();
+    TEST_ASSERT_EQUAL_UINT(1, gfx.glyphs());
+    TEST_ASSERT_TRUE(gfx.drew("5"));
+    TEST_ASSERT_TRUE(rowsTouched(TEMP_Y, TEMP_Y + 32));
+    TEST_ASSERT_FALSE(rowsTouched(0, TEMP_Y));
+    TEST_ASSERT_FALSE(rowsTouched(STATE_Y, 320));
+}
+
+static void test_temp_moves_bar() {
+    brew.set(brew.temp, (int16_t)500, (uint16_t)BF_TEMP);
+    frame();
+    const Layout::Spec &bar = Layout::find(portrait::TABLE, Ids::W_BAR);
+    TEST_ASSERT_TRUE(gfx.touched(bar.x, bar.y, bar.w, bar.h));
+    TEST_ASSERT_FALSE(rowsTouched(STATE_Y, 320));
+}
+
+static void test_state_redraws_state_label() {
+    brew.setState("BREW", 4);
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("[0]BREW"));
+    TEST_ASSERT_TRUE(rowsTouched(STATE_Y, BUTTONS_Y));
+    TEST_ASSERT_FALSE(rowsTouched(0, STATE_Y));
+    TEST_ASSERT_FALSE(rowsTouched(BUTTONS_Y, 320));
+}
+
+static void test_relay_redraws_its_dot() {
+    brew.set(brew.pump, true, (uint16_t)BF_PUMP);
+    frame();
+    const Layout::Spec &pump = Layout::find(portrait::TABLE, Ids::W_PUMP);
+    const Layout::Spec &boiler = Layout::find(portrait::TABLE, Ids::W_BOILER);
+    TEST_ASSERT_TRUE(gfx.touched(pump.x - pump.w, pump.y - pump.w, 2 * pump.w + 1, 2 * pump.w + 1));
+    TEST_ASSERT_FALSE(gfx.touched(boiler.x - boiler.w, boiler.y - boiler.w,
+                                  2 * boiler.w + 1, 2 * boiler.w + 1));
+    TEST_ASSERT_FALSE(rowsTouched(0, STATE_Y));
+}
+
+static void test_connection_redraws_title_dot() {
+    brew.set(brew.connected, true, (uint16_t)BF_CONNECTED);
+    frame();
+    TEST_ASSERT_TRUE(rowsTouched(0, TITLE_H));
+    TEST_ASSERT_FALSE(gfx.drew("BrewForge"));
+    TEST_ASSERT_FALSE(rowsTouched(TITLE_H, 320));
+}
+
+static void test_flow_and_volume() {
+    brew.set(brew.flow, (int16_t)18, (uint16_t)BF_FLOW);
+    frame();
+    TEST_ASSERT_TRUE(rowsTouched(FLOW_Y, FLOW_Y + 20));
+    TEST_ASSERT_FALSE(rowsTouched(FLOW_Y + 20, 320));
+    TEST_ASSERT_FALSE(rowsTouched(0, FLOW_Y));
+
+    brew.set(brew.volume, (int16_t)215, (uint16_t)BF_VOLUME);
+    frame();
+    TEST_ASSERT_TRUE(rowsTouched(FLOW_Y + 20, TEMPADJ_Y));
+    TEST_ASSERT_FALSE(rowsTouched(0, FLOW_Y + 20));
+}
+
+static void test_target_redraws_target_and_bar() {
+    brew.set(brew.target, (int16_t)900, (uint16_t)BF_TARGET);
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("Target: 90C"));
+    const Layout::Spec &bar = Layout::find(portrait::TABLE, Ids::W_BAR);
+    TEST_ASSERT_TRUE(gfx.touched(bar.x, bar.y, bar.w, bar.h));  // Recoloured
+    TEST_ASSERT_FALSE(rowsTouched(STATE_Y, 320));
+}
+
+static void test_overlay_replaces_graph_button() {
+    screen->setOverlayVisible(true);
+    screen->setOverlayLine(0, "frame 1.2ms");
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("frame 1.2ms"));
+    TEST_ASSERT_FALSE(gfx.drew("GRAPH"));
+    TEST_ASSERT_FALSE(rowsTouched(0, NAV_Y));
+
+    screen->setOverlayVisible(false);
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("GRAPH"));
+    TEST_ASSERT_FALSE(rowsTouched(0, NAV_Y));
+}
+
+static void test_update_progress_in_nav() {
+    screen->setUpdateProgress(40);
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("UPDATING 40%"));
+    TEST_ASSERT_FALSE(rowsTouched(0, NAV_Y));
+
+    screen->setUpdateProgress(41);
+    frame();
+    TEST_ASSERT_TRUE(gfx.drew("UPDATING 41%"));
+    TEST_ASSERT_FALSE(gfx.drew("GRAPH"));
+}
+
+static void test_repeat_only_on_temp_buttons() {
+    const Layout::Spec &up = Layout::find(portrait::TABLE, Ids::W_TEMPUP);
+    const Layout::Spec &brewBtn = Layout::find(portrait::TABLE, Ids::W_BREW);
+    TEST_ASSERT_TRUE(screen->acceptsRepeat(up.x + 5, up.y + 5));
+    TEST_ASSERT_FALSE(screen->acceptsRepeat(brewBtn.x + 5, brewBtn.y + 5));
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_draw_paints_everything);
+    RUN_TEST(test_idle_draws_nothing);
+    RUN_TEST(test_unchanged_frame_draws_nothing);
+    RUN_TEST(test_temp_redraws_changed_cells_only);
+    RUN_TEST(test_temp_moves_bar);
+    RUN_TEST(test_state_redraws_state_label);
+    RUN_TEST(test_relay_redraws_its_dot);
+    RUN_TEST(test_connection_redraws_title_dot);
+    RUN_TEST(test_flow_and_volume);
+    RUN_TEST(test_target_redraws_target_and_bar);
+    RUN_TEST(test_overlay_replaces_graph_button);
+    RUN_TEST(test_update_progress_in_nav);
+    RUN_TEST(test_repeat_only_on_temp_buttons);
+    return UNITY_END();
+}
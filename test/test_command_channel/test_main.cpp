@@ -0,0 +1,193 @@
+// CommandChannel: acks, retries, coalescing, the untagged fallback and
+// what a lost link does to all of them
+
+#include <unity.h>
+
+#include <string>
+
+#include "CommandChannel.h"
+
+using namespace PicoProto;
+
+// Everything written to the link, one line per command
+class Capture : public Print {
+public:
+    std::string out;
+    using Print::write;
+    size_t write(uint8_t c) override {
+        out += (char)c;
+        return 1;
+    }
+    std::string take() {
+        std::string s = out;
+        out.clear();
+        return s;
+    }
+};
+
+static Capture link, logOut;
+static CommandChannel *ch;
+static uint32_t now;
+
+void setUp() {
+    link.out.clear();
+    logOut.out.clear();
+    ch = new CommandChannel(link, logOut);
+    now = 1000;
+    ch->onStatus();
+}
+
+void tearDown() { delete ch; }
+
+static void submit(char op, int16_t arg = 0) {
+    PicoCommand c;
+    c.op = op;
+    c.arg = arg;
+    ch->submit(c, now);
+}
+
+// Let every retry of the command in flight time out; status frames keep
+// arriving in between if alive
+static void exhaust(bool alive) {
+    for (uint8_t i = 0; i < CommandChannel::MAX_SENDS; i++) {
+        now += CommandChannel::ACK_TIMEOUT_MS;
+        if (alive) ch->onStatus();
+        ch->poll(now);
+    }
+}
+
+static void test_tagged_and_acked() {
+    submit(OP_BREW);
+    TEST_ASSERT_EQUAL_STRING("C1:b\n", link.take().c_str());
+    TEST_ASSERT_FALSE(ch->idle());
+    ch->onAck(1, now);
+    TEST_ASSERT_TRUE(ch->idle());
+
+    submit(OP_TARGET, 5);
+    TEST_ASSERT_EQUAL_STRING("C2:T+5\n", link.take().c_str());
+}
+
+static void test_retry_keeps_seq() {
+    submit(OP_BREW);
+    link.take();
+    now += CommandChannel::ACK_TIMEOUT_MS - 1;
+    ch->poll(now);
+    TEST_ASSERT_EQUAL_STRING("", link.take().c_str());
+    now += 1;
+    ch->poll(now);
+    TEST_ASSERT_EQUAL_STRING("C1:b\n", link.take().c_str());
+}
+
+static void test_stale_ack_ignored() {
+    submit(OP_BREW);
+    ch->onAck(7, now);
+    TEST_ASSERT_FALSE(ch->idle());
+}
+
+static void test_targets_coalesce_behind_busy_link() {
+    submit(OP_BREW);
+    for (int i = 0; i < 5; i++) submit(OP_TARGET, 5);
+    link.take();
+    ch->onAck(1, now);
+    TEST_ASSERT_EQUAL_STRING("C2:T+25\n", link.take().c_str());
+}
+
+static void test_stop_jumps_queue_and_cancels_brew() {
+    submit(OP_TARGET, 5);
+    submit(OP_BREW);
+    submit(OP_STOP);
+    link.take();
+    ch->onAck(1, now);
+    TEST_ASSERT_EQUAL_STRING("C2:x\n", link.take().c_str());
+    ch->onAck(2, now);
+    TEST_ASSERT_TRUE(ch->idle());
+}
+
+static void test_silent_pico_falls_back_to_untagged() {
+    submit(OP_TARGET, 10);
+    exhaust(true);
+    TEST_ASSERT_TRUE(ch->untagged());
+    TEST_ASSERT_EQUAL_STRING("C1:T+10\nC1:T+10\nC1:T+10\nC1:T+10\n+\n+\n", link.take().c_str());
+
+    submit(OP_BREW);
+    TEST_ASSERT_EQUAL_STRING("b\n", link.take().c_str());
+    TEST_ASSERT_TRUE(ch->idle());
+}
+
+static void test_dead_link_is_not_an_old_pico() {
+    submit(OP_BREW);
+    exhaust(false);
+    TEST_ASSERT_FALSE(ch->untagged());
+    TEST_ASSERT_TRUE(ch->idle());
+    link.take();
+
+    submit(OP_STOP);
+    TEST_ASSERT_EQUAL_STRING("C2:x\n", link.take().c_str());
+}
+
+static void test_acked_pico_never_falls_back() {
+    submit(OP_BREW);
+    ch->onAck(1, now);
+    submit(OP_STOP);
+    exhaust(true);
+    TEST_ASSERT_FALSE(ch->untagged());
+    TEST_ASSERT_TRUE(ch->idle());
+}
+
+static void test_nothing_queued_without_link() {
+    ch->reset();
+    submit(OP_BREW);
+    TEST_ASSERT_TRUE(ch->idle());
+    TEST_ASSERT_EQUAL_STRING("", link.take().c_str());
+
+    // Nothing held back to go out once the Pico is back either
+    ch->onStatus();
+    ch->poll(now);
+    TEST_ASSERT_EQUAL_STRING("", link.take().c_str());
+}
+
+static void test_reset_drops_inflight_and_queue() {
+    submit(OP_BREW);
+    submit(OP_TARGET, 5);
+    ch->reset();
+    TEST_ASSERT_TRUE(ch->idle());
+    link.take();
+
+    // A late ack or timeout of the dropped command does nothing
+    ch->onAck(1, now);
+    exhaust(false);
+    TEST_ASSERT_EQUAL_STRING("", link.take().c_str());
+    TEST_ASSERT_FALSE(ch->untagged());
+}
+
+static void test_reset_rechecks_fallback() {
+    submit(OP_BREW);
+    exhaust(true);
+    TEST_ASSERT_TRUE(ch->untagged());
+
+    // Reconnects with firmware that acks
+    ch->reset();
+    TEST_ASSERT_FALSE(ch->untagged());
+    ch->onStatus();
+    link.take();
+    submit(OP_STOP);
+    TEST_ASSERT_EQUAL_STRING("C2:x\n", link.take().c_str());
+    ch->onAck(2, now);
+    TEST_ASSERT_TRUE(ch->idle());
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tagged_and_acked);
+    RUN_TEST(test_retry_keeps_seq);
+    RUN_TEST(test_stale_ack_ignored);
+    RUN_TEST(test_targets_coalesce_behind_busy_link);
+    RUN_TEST(test_stop_jumps_queue_and_cancels_brew);
+    RUN_TEST(test_silent_pico_falls_back_to_untagged);
+    RUN_TEST(test_dead_link_is_not_an_old_pico);
+    RUN_TEST(test_acked_pico_never_falls_back);
+    RUN_TEST(test_nothing_queued_without_link);
+    RUN_TEST(test_reset_drops_inflight_and_queue);
+    RUN_TEST(test_reset_rechecks_fallback);
+    return UNITY_END();
+}
@@ -0,0 +1,61 @@
+// FixedFmt: scaled integers to text
+
+#include <unity.h>
+
+#include "FixedFmt.h"
+
+using FixedFmt::TextBuf;
+
+static char buf[32];
+
+void setUp() { memset(buf, 'x', sizeof(buf)); }
+
+void tearDown() {}
+
+static void test_fixed() {
+    TEST_ASSERT_EQUAL_STRING("92.4", TextBuf(buf, sizeof(buf)).fixed(924, 1).c_str());
+    TEST_ASSERT_EQUAL_STRING("0.5", TextBuf(buf, sizeof(buf)).fixed(5, 1).c_str());
+    TEST_ASSERT_EQUAL_STRING("-0.05", TextBuf(buf, sizeof(buf)).fixed(-5, 2).c_str());
+    TEST_ASSERT_EQUAL_STRING("-32768", TextBuf(buf, sizeof(buf)).fixed(-32768, 0).c_str());
+}
+
+static void test_width_and_sign() {
+    TEST_ASSERT_EQUAL_STRING("  0.0C", TextBuf(buf, sizeof(buf)).fixed(0, 1, 5).put('C').c_str());
+    TEST_ASSERT_EQUAL_STRING(" -1.5", TextBuf(buf, sizeof(buf)).fixed(-15, 1, 5).c_str());
+    TEST_ASSERT_EQUAL_STRING("+1.2", TextBuf(buf, sizeof(buf)).fixed(12, 1, 0, true).c_str());
+    TEST_ASSERT_EQUAL_STRING("123.4", TextBuf(buf, sizeof(buf)).fixed(1234, 1, 3).c_str());
+}
+
+static void test_integer_and_put() {
+    TextBuf t(buf, sizeof(buf));
+    t.put("Target: ").integer(93).put('C');
+    TEST_ASSERT_EQUAL_STRING("Target: 93C", t.c_str());
+    TEST_ASSERT_EQUAL_UINT(11, t.length());
+    TEST_ASSERT_EQUAL_STRING("  12/30s",
+        TextBuf(buf, sizeof(buf)).integer(12, 4).put('/').integer(30).put('s').c_str());
+}
+
+static void test_truncates_and_terminates() {
+    char small[5];
+    TextBuf t(small, sizeof(small));
+    t.put("Flow ").fixed(12, 1);
+    TEST_ASSERT_EQUAL_STRING("Flow", small);
+    TEST_ASSERT_EQUAL_UINT(4, t.length());
+}
+
+static void test_round_div() {
+    TEST_ASSERT_EQUAL_INT(93, FixedFmt::roundDiv(925, 10));
+    TEST_ASSERT_EQUAL_INT(92, FixedFmt::roundDiv(924, 10));
+    TEST_ASSERT_EQUAL_INT(-93, FixedFmt::roundDiv(-925, 10));
+    TEST_ASSERT_EQUAL_INT(0, FixedFmt::roundDiv(-4, 10));
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed);
+    RUN_TEST(test_width_and_sign);
+    RUN_TEST(test_integer_and_put);
+    RUN_TEST(test_truncates_and_terminates);
+    RUN_TEST(test_round_div);
+    return UNITY_END();
+}
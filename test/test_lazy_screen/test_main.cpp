@@ -0,0 +1,118 @@
+// LazyScreenManager: the panel scroll across screen switches, immediate
+// and deferred
+
+#include <unity.h>
+
+#include "BrewScreen.h"
+#include "GraphScreen.h"
+#include "LazyScreen.h"
+#include "MockGfx.h"
+#include "PanelScroll.h"
+
+static const ForgeTheme theme = forgeThemeDark(240, 320);
+static MockGfx gfx;
+static TFT_eSPI tft;
+static BrewStatus brew;
+static GraphScreen::History history;
+
+static PanelScroll *scroll;
+static LazyScreenManager *mgr;
+static BrewScreen *brewScreen;
+static GraphScreen *graphScreen;
+static int brewIdx, graphIdx;
+
+void setUp() {
+    scroll = new PanelScroll(tft);
+    mgr = new LazyScreenManager();
+    brewScreen = new BrewScreen(gfx, theme, brew);
+    graphScreen = new GraphScreen(gfx, theme, tft, *scroll, history, brew);
+    brewIdx = mgr->addScreen(brewScreen);
+    graphIdx = mgr->addScreen(graphScreen);
+    mgr->setPanelScroll(scroll);
+    mgr->showScreen(brewIdx);
+}
+
+void tearDown() {
+    delete graphScreen;
+    delete brewScreen;
+    delete mgr;
+    delete scroll;
+}
+
+static void assertPlotScrolls() {
+    TEST_ASSERT_TRUE(scroll->active());
+    TEST_ASSERT_EQUAL_INT16(25, scroll->areaTop());
+    TEST_ASSERT_EQUAL_INT16(245, scroll->areaRows());
+}
+
+static void test_no_scroll_on_brew_screen() {
+    TEST_ASSERT_FALSE(scroll->active());
+}
+
+static void test_immediate_switch_keeps_graph_scroll() {
+    mgr->showScreen(graphIdx);
+    TEST_ASSERT_EQUAL_INT(graphIdx, mgr->currentScreen());
+    assertPlotScrolls();
+}
+
+// GRAPH and BACK go through deferShowScreen(), so this is the usual path
+static void test_deferred_switch_keeps_graph_scroll() {
+    mgr->deferShowScreen(graphIdx);
+    mgr->processDeferredActions();
+    TEST_ASSERT_EQUAL_INT(graphIdx, mgr->currentScreen());
+    assertPlotScrolls();
+
+    // Drawing scrolls rather than repainting over a lost area
+    graphScreen->update();
+    graphScreen->draw();
+    assertPlotScrolls();
+}
+
+static void test_leaving_graph_resets_scroll() {
+    mgr->deferShowScreen(graphIdx);
+    mgr->processDeferredActions();
+    mgr->deferShowScreen(brewIdx);
+    mgr->processDeferredActions();
+    TEST_ASSERT_EQUAL_INT(brewIdx, mgr->currentScreen());
+    TEST_ASSERT_FALSE(scroll->active());
+    TEST_ASSERT_EQUAL_INT16(0, scroll->scrollOffset());
+}
+
+static void test_reentering_graph_scrolls_again() {
+    for (int i = 0; i < 3; i++) {
+        mgr->deferShowScreen(graphIdx);
+        mgr->processDeferredActions();
+        assertPlotScrolls();
+        mgr->showScreen(brewIdx);
+        TEST_ASSERT_FALSE(scroll->active());
+    }
+}
+
+static void test_switch_to_same_screen_keeps_scroll() {
+    mgr->showScreen(graphIdx);
+    mgr->deferShowScreen(graphIdx);
+    mgr->processDeferredActions();
+    assertPlotScrolls();
+}
+
+// A screen that left the panel in partial mode gets normal scan-out back
+static void test_switch_clears_partial_mode() {
+    mgr->showScreen(graphIdx);
+    scroll->setPartial(25, 269);
+    mgr->deferShowScreen(brewIdx);
+    mgr->processDeferredActions();
+    TEST_ASSERT_FALSE(scroll->isPartial());
+    TEST_ASSERT_FALSE(scroll->active());
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_scroll_on_brew_screen);
+    RUN_TEST(test_immediate_switch_keeps_graph_scroll);
+    RUN_TEST(test_deferred_switch_keeps_graph_scroll);
+    RUN_TEST(test_leaving_graph_resets_scroll);
+    RUN_TEST(test_reentering_graph_scrolls_again);
+    RUN_TEST(test_switch_to_same_screen_keeps_scroll);
+    RUN_TEST(test_switch_clears_partial_mode);
+    return UNITY_END();
+}
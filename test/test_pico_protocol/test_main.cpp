@@ -0,0 +1,179 @@
+// PicoProtocol: CRC, full and delta status frames, acks
+
+#include <unity.h>
+
+#include <vector>
+
+#include "PicoProtocol.h"
+
+using namespace PicoProto;
+
+static BrewStatus status;
+
+void setUp() {
+    status = BrewStatus();
+    status.dirty = 0;
+}
+
+void tearDown() {}
+
+// A frame as the receiver stores it: type, len, payload, crc (no SYNC)
+static std::vector<uint8_t> frame(uint8_t type, const void *payload, uint8_t len) {
+    std::vector<uint8_t> f{ type, len };
+    const uint8_t *p = (const uint8_t *)payload;
+    f.insert(f.end(), p, p + len);
+    const uint16_t crc = crc16(f.data(), f.size());
+    f.push_back(crc & 0xFF);
+    f.push_back(crc >> 8);
+    return f;
+}
+
+static StatusPayload brewing() {
+    StatusPayload s;
+    memset(&s, 0, sizeof(s));
+    s.temp = 924;
+    s.tempF = 1983;
+    s.target = 930;
+    s.flow = 18;
+    s.volume = 215;
+    s.tempRate = -12;
+    s.step = 3;
+    s.stepElapsed = 12;
+    s.stepTime = 30;
+    s.relays = RELAY_PUMP | RELAY_SOLENOID;
+    memcpy(s.state, "BREW", 4);
+    return s;
+}
+
+static void test_crc_check_value() {
+    // CRC-16/CCITT-FALSE of "123456789"
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16((const uint8_t *)"123456789", 9));
+}
+
+static void test_full_status() {
+    const StatusPayload s = brewing();
+    auto f = frame(FRAME_STATUS, &s, sizeof(s));
+    TEST_ASSERT_TRUE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_INT16(924, status.temp);
+    TEST_ASSERT_EQUAL_INT16(1983, status.tempF);
+    TEST_ASSERT_EQUAL_INT16(930, status.target);
+    TEST_ASSERT_EQUAL_INT16(18, status.flow);
+    TEST_ASSERT_EQUAL_INT16(215, status.volume);
+    TEST_ASSERT_EQUAL_INT16(-12, status.tempRate);
+    TEST_ASSERT_EQUAL_INT(3, status.step);
+    TEST_ASSERT_EQUAL_INT(12, status.stepElapsed);
+    TEST_ASSERT_EQUAL_INT(30, status.stepTime);
+    TEST_ASSERT_TRUE(status.pump);
+    TEST_ASSERT_FALSE(status.boiler);
+    TEST_ASSERT_TRUE(status.solenoid);
+    TEST_ASSERT_FALSE(status.warmer);
+    TEST_ASSERT_EQUAL_STRING("BREW", status.state);
+}
+
+static void test_full_state_without_terminator() {
+    StatusPayload s = brewing();
+    memcpy(s.state, "PREHEAT!", STATE_LEN);
+    auto f = frame(FRAME_STATUS, &s, sizeof(s));
+    TEST_ASSERT_TRUE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_STRING("PREHEAT!", status.state);
+}
+
+static void test_repeat_frame_sets_no_dirty_bits() {
+    const StatusPayload s = brewing();
+    auto f = frame(FRAME_STATUS, &s, sizeof(s));
+    decode(f.data(), f.size(), status);
+    status.takeDirty();
+    TEST_ASSERT_TRUE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_HEX16(0, status.dirty);
+}
+
+static void test_delta() {
+    const StatusPayload s = brewing();
+    auto full = frame(FRAME_STATUS, &s, sizeof(s));
+    decode(full.data(), full.size(), status);
+    status.takeDirty();
+
+    // Mask (little-endian), then temp and relays in Field order
+    const uint16_t mask = (1 << F_TEMP) | (1 << F_RELAYS);
+    const uint8_t delta[] = { mask & 0xFF, mask >> 8, 0x9A, 0x03, RELAY_BOILER };
+    auto f = frame(FRAME_DELTA, delta, sizeof(delta));
+    TEST_ASSERT_TRUE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_INT16(922, status.temp);
+    TEST_ASSERT_TRUE(status.boiler);
+    TEST_ASSERT_FALSE(status.pump);
+    TEST_ASSERT_EQUAL_INT16(18, status.flow);  // Not in the mask
+    TEST_ASSERT_EQUAL_HEX16(BF_TEMP | BF_PUMP | BF_BOILER | BF_SOLENOID, status.dirty);
+}
+
+static void test_delta_size_mismatch_applies_nothing() {
+    const uint8_t delta[] = { (1 << F_TEMP) | (1 << F_FLOW), 0, 0x9A, 0x03 };  // flow missing
+    auto f = frame(FRAME_DELTA, delta, sizeof(delta));
+    TEST_ASSERT_FALSE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_INT16(0, status.temp);
+    TEST_ASSERT_EQUAL_HEX16(0, status.dirty);
+}
+
+static void test_bad_crc() {
+    const StatusPayload s = brewing();
+    auto f = frame(FRAME_STATUS, &s, sizeof(s));
+    f[5] ^= 0x01;
+    TEST_ASSERT_FALSE(decode(f.data(), f.size(), status));
+    TEST_ASSERT_EQUAL_INT16(0, status.temp);
+}
+
+static void test_bad_lengths() {
+    const StatusPayload s = brewing();
+    auto f = frame(FRAME_STATUS, &s, sizeof(s));
+    TEST_ASSERT_FALSE(decode(f.data(), f.size() - 1, status));  // Truncated
+    TEST_ASSERT_FALSE(decode(f.data(), 3, status));
+
+    auto shortStatus = frame(FRAME_STATUS, &s, sizeof(s) - 2);  // Valid CRC, wrong size
+    TEST_ASSERT_FALSE(decode(shortStatus.data(), shortStatus.size(), status));
+    TEST_ASSERT_EQUAL_INT16(0, status.temp);
+}
+
+static void test_unknown_type() {
+    const StatusPayload s = brewing();
+    auto f = frame(0x7F, &s, sizeof(s));
+    TEST_ASSERT_FALSE(decode(f.data(), f.size(), status));
+}
+
+static void test_ack() {
+    const uint8_t seq[] = { 0x34, 0x12 };
+    auto f = frame(FRAME_ACK, seq, sizeof(seq));
+    uint16_t got = 0;
+    TEST_ASSERT_TRUE(decodeAck(f.data(), f.size(), got));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, got);
+
+    // Not a status frame either
+    TEST_ASSERT_FALSE(decode(f.data(), f.size(), status));
+}
+
+static void test_ack_rejects_others() {
+    const StatusPayload s = brewing();
+    auto full = frame(FRAME_STATUS, &s, sizeof(s));
+    uint16_t got = 7;
+    TEST_ASSERT_FALSE(decodeAck(full.data(), full.size(), got));
+
+    const uint8_t seq[] = { 0x34, 0x12 };
+    auto bad = frame(FRAME_ACK, seq, sizeof(seq));
+    bad.back() ^= 0xFF;
+    TEST_ASSERT_FALSE(decodeAck(bad.data(), bad.size(), got));
+    TEST_ASSERT_EQUAL_UINT16(7, got);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_full_status);
+    RUN_TEST(test_full_state_without_terminator);
+    RUN_TEST(test_repeat_frame_sets_no_dirty_bits);
+    RUN_TEST(test_delta);
+    RUN_TEST(test_delta_size_mismatch_applies_nothing);
+    RUN_TEST(test_bad_crc);
+    RUN_TEST(test_bad_lengths);
+    RUN_TEST(test_unknown_type);
+    RUN_TEST(test_ack);
+    RUN_TEST(test_ack_rejects_others);
+    return UNITY_END();
+}
@@ -0,0 +1,71 @@
+// Spsc.h on one thread: SpscQueue order and LossyRing overwrite accounting
+
+#include <unity.h>
+
+#include "Spsc.h"
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_queue_fifo_and_full() {
+    SpscQueue<int, 4> q;
+    for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(q.push(i));
+    int v = -1;
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_EQUAL_INT(0, v);
+    while (q.push(9)) {}
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_EQUAL_INT(1, v);
+}
+
+static void test_ring_drops_oldest() {
+    LossyRing<int, 4> r;
+    for (int i = 0; i < 6; i++) r.push(i);
+    int v = -1;
+    TEST_ASSERT_TRUE(r.pop(v));
+    TEST_ASSERT_EQUAL_INT(2, v);
+    TEST_ASSERT_EQUAL_UINT32(2, r.dropped());
+    for (int want = 3; want < 6; want++) {
+        TEST_ASSERT_TRUE(r.pop(v));
+        TEST_ASSERT_EQUAL_INT(want, v);
+    }
+    TEST_ASSERT_FALSE(r.pop(v));
+}
+
+static void test_peek_keeps_entry() {
+    LossyRing<int, 4> r;
+    r.push(7);
+    r.push(8);
+    int v = -1;
+    TEST_ASSERT_TRUE(r.peek(v));
+    TEST_ASSERT_EQUAL_INT(7, v);
+    TEST_ASSERT_TRUE(r.peek(v));  // Not consumed: same one again
+    TEST_ASSERT_EQUAL_INT(7, v);
+    r.consume();
+    TEST_ASSERT_TRUE(r.peek(v));
+    TEST_ASSERT_EQUAL_INT(8, v);
+    TEST_ASSERT_EQUAL_UINT32(0, r.dropped());
+}
+
+static void test_peeked_entry_overwritten_counts_as_dropped() {
+    LossyRing<int, 4> r;
+    r.push(0);
+    int v = -1;
+    TEST_ASSERT_TRUE(r.peek(v));
+
+    // Held while the producer laps it
+    for (int i = 1; i <= 5; i++) r.push(i);
+    TEST_ASSERT_TRUE(r.peek(v));
+    TEST_ASSERT_EQUAL_INT(2, v);
+    TEST_ASSERT_EQUAL_UINT32(2, r.dropped());
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_fifo_and_full);
+    RUN_TEST(test_ring_drops_oldest);
+    RUN_TEST(test_peek_keeps_entry);
+    RUN_TEST(test_peeked_entry_overwritten_counts_as_dropped);
+    return UNITY_END();
+}
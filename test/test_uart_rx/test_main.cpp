@@ -0,0 +1,160 @@
+// UartLineRing: framing JSON lines and binary frames into slots
+
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "UartRx.h"
+
+using Ring = UartLineRing<4, 64 + PicoProto::MAX_FRAME_LEN>;
+
+static Ring *ring;
+
+void setUp() { ring = new Ring(); }
+
+void tearDown() { delete ring; }
+
+static void feed(const char *s) { ring->feed((const uint8_t *)s, strlen(s)); }
+
+static void feed(const std::vector<uint8_t> &bytes) { ring->feed(bytes.data(), bytes.size()); }
+
+// The next span as a string, or "" if none; releases it
+static std::string take(bool *binary = nullptr) {
+    RxSpan span;
+    if (!ring->peek(span)) return "";
+    std::string s(span.data, span.len);
+    if (binary) *binary = span.binary;
+    ring->release();
+    return s;
+}
+
+// A binary frame on the wire, SYNC included
+static std::vector<uint8_t> wireFrame(uint8_t type, const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> f{ PicoProto::SYNC, type, (uint8_t)payload.size() };
+    f.insert(f.end(), payload.begin(), payload.end());
+    const uint16_t crc = PicoProto::crc16(f.data() + 1, f.size() - 1);
+    f.push_back(crc & 0xFF);
+    f.push_back(crc >> 8);
+    return f;
+}
+
+static void test_lines_split_on_newline() {
+    feed("{\"temp\":1}\n{\"te");
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":1}", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("", take().c_str());  // Second line still open
+
+    feed("mp\":2}\n");
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":2}", take().c_str());
+    TEST_ASSERT_EQUAL_UINT32(2, ring->stats().frames);
+}
+
+static void test_empty_lines_and_control_chars_dropped() {
+    feed("\n\r\n{\"a\":\t1}\r\n");
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("", take().c_str());
+}
+
+static void test_binary_frame_framed_by_length() {
+    // The payload holds '\n' and SYNC bytes, which must not split it
+    auto f = wireFrame(PicoProto::FRAME_ACK, { '\n', PicoProto::SYNC });
+    feed(f);
+    bool binary = false;
+    const std::string got = take(&binary);
+    TEST_ASSERT_TRUE(binary);
+    TEST_ASSERT_EQUAL_UINT(f.size() - 1, got.size());  // SYNC is not stored
+    TEST_ASSERT_EQUAL_MEMORY(f.data() + 1, got.data(), got.size());
+
+    uint16_t seq = 0;
+    TEST_ASSERT_TRUE(PicoProto::decodeAck((const uint8_t *)got.data(), got.size(), seq));
+    TEST_ASSERT_EQUAL_HEX16(0xA50A, seq);
+}
+
+static void test_mixed_json_and_binary() {
+    feed("{\"temp\":1}\n");
+    feed(wireFrame(PicoProto::FRAME_ACK, { 1, 0 }));
+    feed("{\"temp\":2}\n");
+
+    bool binary = true;
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":1}", take(&binary).c_str());
+    TEST_ASSERT_FALSE(binary);
+    take(&binary);
+    TEST_ASSERT_TRUE(binary);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":2}", take(&binary).c_str());
+    TEST_ASSERT_FALSE(binary);
+}
+
+static void test_sync_abandons_partial_line() {
+    feed("{\"temp\":");
+    feed(wireFrame(PicoProto::FRAME_ACK, { 1, 0 }));
+    feed("{\"temp\":3}\n");
+
+    bool binary = false;
+    take(&binary);
+    TEST_ASSERT_TRUE(binary);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":3}", take().c_str());
+}
+
+static void test_full_ring_drops_whole_lines() {
+    for (int i = 0; i < 6; i++) {
+        char line[16];
+        snprintf(line, sizeof(line), "line%d\n", i);
+        feed(line);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, ring->stats().frames);
+    TEST_ASSERT_EQUAL_UINT32(2, ring->stats().dropped);
+
+    // The queued lines survive intact, oldest first
+    TEST_ASSERT_EQUAL_STRING("line0", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("line1", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("line2", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("line3", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("", take().c_str());
+
+    feed("line6\n");
+    TEST_ASSERT_EQUAL_STRING("line6", take().c_str());
+}
+
+static void test_full_ring_drops_binary_frames() {
+    for (int i = 0; i < 4; i++) feed("x\n");
+    feed(wireFrame(PicoProto::FRAME_ACK, { 1, 0 }));
+    TEST_ASSERT_EQUAL_UINT32(1, ring->stats().dropped);
+
+    // The dropped frame's bytes don't leak into the next line
+    take();
+    feed("after\n");
+    for (int i = 0; i < 3; i++) take();
+    TEST_ASSERT_EQUAL_STRING("after", take().c_str());
+}
+
+static void test_overlong_line_discarded_to_newline() {
+    std::string big(64 + PicoProto::MAX_FRAME_LEN + 10, 'a');
+    feed(big.c_str());
+    feed("tail\nok\n");
+    TEST_ASSERT_EQUAL_UINT32(1, ring->stats().overlong);
+    TEST_ASSERT_EQUAL_STRING("ok", take().c_str());
+    TEST_ASSERT_EQUAL_STRING("", take().c_str());
+}
+
+static void test_counters() {
+    ring->noteHwOverrun();
+    ring->noteBadFrame();
+    ring->noteBadFrame();
+    const UartRxStats s = ring->stats();
+    TEST_ASSERT_EQUAL_UINT32(1, s.hwOverruns);
+    TEST_ASSERT_EQUAL_UINT32(2, s.badFrames);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lines_split_on_newline);
+    RUN_TEST(test_empty_lines_and_control_chars_dropped);
+    RUN_TEST(test_binary_frame_framed_by_length);
+    RUN_TEST(test_mixed_json_and_binary);
+    RUN_TEST(test_sync_abandons_partial_line);
+    RUN_TEST(test_full_ring_drops_whole_lines);
+    RUN_TEST(test_full_ring_drops_binary_frames);
+    RUN_TEST(test_overlong_line_discarded_to_newline);
+    RUN_TEST(test_counters);
+    return UNITY_END();
+}
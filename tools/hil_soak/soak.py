@@ -0,0 +1,460 @@
+#!/usr/bin/env python3
+"""
+BrewForge HMI Soak Test
+Stands in for the Pico on the HMI's Serial2, streams recorded, synthetic
+and fuzzed status frames, injects taps over the USB console and logs the
+HMI's [SOAK] health lines over long runs (see README.md)
+"""
+import argparse
+import csv
+import random
+import re
+import struct
+import sys
+import threading
+import time
+from pathlib import Path
+
+try:
+    import serial
+except ImportError:
+    sys.exit("pyserial is required: pip install pyserial")
+
+# ---- Wire protocol (include/PicoProtocol.h) ----
+
+SYNC = 0xA5
+FRAME_STATUS, FRAME_DELTA, FRAME_ACK = 0x01, 0x02, 0x03
+RELAY_PUMP, RELAY_BOILER, RELAY_SOLENOID, RELAY_WARMER = 1, 2, 4, 8
+STATUS_FMT = "<hhhhhhBHHB8s"  # StatusPayload, 26 bytes
+FIELD_FMT = ["<h", "<h", "<h", "<h", "<h", "<h", "<B", "<H", "<H", "<B", "8s"]
+MAX_LINE = 1024  # BrewJson::MAX_FRAME_LEN
+LINK_TIMEOUT_S = 3.0  # LINK_TIMEOUT_MS
+
+# Screen coordinates of tap targets (include/BrewLayout.h, GraphScreen.h).
+# CAL is left out: the calibration screen waits for real touches.
+TAP_TARGETS = {
+    "brew": (61, 150),
+    "stop": (179, 150),
+    "down": (32, 245),
+    "up": (92, 245),
+    "graph": (120, 295),  # Between ZOOM and BACK on the graph screen
+    "zoom": (61, 295),
+    "back": (179, 295),
+}
+HOLD_TARGETS = ("down", "up")  # Hold-to-ramp
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE"""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def frame(ftype, payload):
+    body = bytes([ftype, len(payload)]) + payload
+    return bytes([SYNC]) + body + struct.pack("<H", crc16(body))
+
+
+# ---- Simulated machine ----
+
+
+class Machine:
+    """Just enough of the Pico's brew program to keep every field moving"""
+
+    def __init__(self, rng):
+        self.rng = rng
+        self.temp = 250.0  # 0.1 C
+        self.target = 930
+        self.step = 0
+        self.state = "IDLE"
+        self.elapsed = 0.0
+        self.step_time = 0
+        self.flow = 0.0
+        self.volume = 0.0
+        self.rate = 0.0
+        self.last_rate = None
+
+    def command(self, op, arg=0):
+        if op == "b" and self.step == 0:
+            self.step, self.state, self.elapsed, self.step_time = 1, "PREHEAT", 0.0, 0
+            self.volume = 0.0
+        elif op == "x":
+            self.step, self.state, self.step_time, self.flow = 0, "IDLE", 0, 0.0
+        elif op == "T":
+            self.target = max(200, min(990, self.target + arg * 10))
+
+    def tick(self, dt):
+        before = self.temp
+        self.elapsed += dt
+        heating = self.step in (1, 3) and self.temp < self.target
+        self.temp += (12.0 if heating else -1.5) * dt + self.rng.uniform(-0.6, 0.6)
+        self.temp = max(200.0, self.temp)
+
+        if self.step == 1 and self.temp >= self.target - 5:
+            self.step, self.state, self.elapsed, self.step_time = 3, "BREW", 0.0, 30
+        elif self.step == 3:
+            self.flow = max(0.0, 20 + self.rng.uniform(-4, 4))
+            self.volume += self.flow * dt
+            if self.elapsed >= self.step_time:
+                self.step, self.state, self.elapsed, self.step_time = 7, "DONE", 0.0, 0
+                self.flow = 0.0
+        elif self.step == 7 and self.elapsed >= 5:
+            self.step, self.state, self.elapsed = 0, "IDLE", 0.0
+
+        self.rate = (self.temp - before) / dt * 10 if dt > 0 else 0.0  # 0.01 C/s
+        # Something must change every frame (see soakPoll() in main.cpp)
+        if self.last_rate is not None and int(self.rate) == self.last_rate:
+            self.rate += 1
+        self.last_rate = int(self.rate)
+
+    def relays(self):
+        r = RELAY_BOILER if self.step in (1, 3) and self.temp < self.target else 0
+        if self.step == 3:
+            r |= RELAY_PUMP | RELAY_SOLENOID
+        return r
+
+    def fields(self):
+        t = int(self.temp)
+        return [t, t * 9 // 5 + 320, self.target, int(self.flow), int(self.volume),
+                int(self.rate), self.step, int(self.elapsed), self.step_time,
+                self.relays(), self.state.encode()[:8].ljust(8, b"\0")]
+
+    def binary(self):
+        return frame(FRAME_STATUS, struct.pack(STATUS_FMT, *self.fields()))
+
+    def json(self):
+        f = self.fields()
+        r = f[9]
+        return ('{"temp":%.1f,"tempF":%.1f,"target":%.1f,"state":"%s","step":%d,'
+                '"stepElapsed":%d,"stepTime":%d,"pump":%s,"boiler":%s,"solenoid":%s,'
+                '"warmer":%s,"flow":%.1f,"volume":%.1f,"tempRate":%.2f}\n' % (
+                    f[0] / 10, f[1] / 10, f[2] / 10, self.state, f[6], f[7], f[8],
+                    _b(r & RELAY_PUMP), _b(r & RELAY_BOILER), _b(r & RELAY_SOLENOID),
+                    _b(r & RELAY_WARMER), f[3] / 10, f[4] / 10, f[5] / 100)).encode()
+
+
+def _b(v):
+    return "true" if v else "false"
+
+
+def delta(prev, cur):
+    """FRAME_DELTA with the fields of `cur` that differ from `prev`"""
+    mask, body = 0, b""
+    for i, (a, b) in enumerate(zip(prev, cur)):
+        if a != b:
+            mask |= 1 << i
+            body += struct.pack(FIELD_FMT[i], b)
+    return frame(FRAME_DELTA, struct.pack("<H", mask) + body)
+
+
+# ---- Fuzzing ----
+
+
+def fuzz(data, rng):
+    """One random corruption of a frame or line"""
+    kind = rng.choice(["flip", "truncate", "garbage", "overlong", "sync", "badtype", "split"])
+    buf = bytearray(data)
+    if kind == "flip" and buf:
+        i = rng.randrange(len(buf))
+        buf[i] ^= 1 << rng.randrange(8)
+    elif kind == "truncate" and len(buf) > 2:
+        buf = buf[: rng.randrange(1, len(buf) - 1)]
+    elif kind == "garbage":
+        buf = bytearray(rng.randbytes(rng.randrange(1, 64))) + buf
+    elif kind == "overlong":
+        buf = b'{"temp":' + b"9" * (MAX_LINE + rng.randrange(1, 512)) + b"}\n"
+    elif kind == "sync":
+        buf = bytes([SYNC, rng.randrange(256)]) + buf
+    elif kind == "badtype":
+        buf = frame(rng.choice([0x00, 0x7F, 0xFF]), rng.randbytes(rng.randrange(0, 40)))
+    elif kind == "split":
+        buf = buf + bytes(buf[: len(buf) // 2])
+    return bytes(buf), kind
+
+
+def load_capture(path):
+    """One frame per line: a JSON line, or a binary frame as hex bytes"""
+    frames = []
+    for line in Path(path).read_text().splitlines():
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        if line.startswith("{"):
+            frames.append((line + "\n").encode())
+        else:
+            frames.append(bytes.fromhex(line))
+    if not frames:
+        sys.exit(f"{path}: no frames")
+    return frames
+
+
+# ---- Pico stand-in on the HMI's Serial2 ----
+
+
+class PicoLink:
+    CMD_RE = re.compile(rb"^C(\d+):([bxT])([+-]\d+)?$")
+
+    def __init__(self, port, baud, args, rng):
+        self.ser = serial.Serial(port, baud, timeout=0.02, write_timeout=2)
+        self.args = args
+        self.rng = rng
+        self.machine = Machine(rng)
+        self.capture = load_capture(args.capture) if args.capture else None
+        self.period = 0.2
+        self.subscribed_at = 0.0
+        self.binary = False
+        self.last_seq = None
+        self.last_fields = None
+        self.lock = threading.Lock()
+        self.stats = {"sent": 0, "fuzzed": 0, "bytes": 0, "acks": 0, "cmds": 0, "legacy": 0}
+        self.stop = threading.Event()
+
+    def send(self, data):
+        with self.lock:
+            self.ser.write(data)
+            self.stats["bytes"] += len(data)
+
+    def ack(self, seq):
+        self.stats["acks"] += 1
+        if self.binary:
+            self.send(frame(FRAME_ACK, struct.pack("<H", seq)))
+        else:
+            self.send(b'{"ack":%d}\n' % seq)
+
+    def handle(self, line):
+        if line.startswith(b"S") and line[1:].isdigit():
+            self.period = max(0.02, int(line[1:]) / 1000)
+            self.subscribed_at = time.monotonic()
+        elif line == b"F1":
+            self.binary = True
+        elif line == b"F0":
+            self.binary = False
+        elif m := self.CMD_RE.match(line):
+            seq = int(m.group(1))
+            if seq != self.last_seq:  # A repeat is only re-acked
+                self.last_seq = seq
+                self.stats["cmds"] += 1
+                self.machine.command(m.group(2).decode(), int(m.group(3) or 0))
+            self.ack(seq)
+        elif line in (b"b", b"x", b"+", b"-"):
+            self.stats["legacy"] += 1
+            op = line.decode()
+            self.machine.command("T" if op in "+-" else op, 5 if op == "+" else -5)
+
+    def reader(self):
+        buf = b""
+        while not self.stop.is_set():
+            buf += self.ser.read(256)
+            while b"\n" in buf:
+                line, buf = buf.split(b"\n", 1)
+                self.handle(line.strip())
+
+    def next_frame(self):
+        if self.capture:
+            data = self.capture[self.stats["sent"] % len(self.capture)]
+        else:
+            fields = self.machine.fields()
+            if not self.binary:
+                data = self.machine.json()
+            elif self.last_fields and self.rng.random() < self.args.delta:
+                data = delta(self.last_fields, fields)
+            else:
+                data = self.machine.binary()
+            self.last_fields = fields
+        self.stats["sent"] += 1
+        if self.rng.random() < self.args.fuzz:
+            data, _ = fuzz(data, self.rng)
+            self.stats["fuzzed"] += 1
+        return data
+
+    def writer(self):
+        last = time.monotonic()
+        start = last
+        while not self.stop.is_set():
+            now = time.monotonic()
+            self.machine.tick(now - last)
+            last = now
+            burst = (self.args.burst_every > 0 and
+                     (now - start) % self.args.burst_every < self.args.burst_secs)
+            # The real Pico stops streaming when the subscription lapses
+            if now - self.subscribed_at < LINK_TIMEOUT_S or self.capture:
+                self.send(self.next_frame())
+            time.sleep(0 if burst else self.period)
+
+    def start(self):
+        for fn in (self.reader, self.writer):
+            threading.Thread(target=fn, daemon=True).start()
+
+
+# ---- HMI USB console ----
+
+
+class Console:
+    SOAK_RE = re.compile(r"\[SOAK\] (.*)")
+    EVENTS = ("rst:", "=== BrewForge HMI", "Guru Meditation", "abort()", "[UART]",
+              "Brownout", "Stack canary", "[HMI->Pico] no acks")
+
+    def __init__(self, port, args, rng, link, out_dir):
+        self.ser = serial.Serial(port, 115200, timeout=0.1)
+        self.args = args
+        self.rng = rng
+        self.link = link
+        self.rows = []
+        self.events = []
+        self.raw = open(out_dir / "console.log", "a", buffering=1)
+        self.csv_file = open(out_dir / "soak.csv", "a", newline="", buffering=1)
+        self.csv = None
+        self.stop = threading.Event()
+
+    def note(self, line):
+        for key in self.EVENTS:
+            if key in line:
+                self.events.append((time.time(), line))
+                print(f"[event] {line}")
+                return
+
+    def record(self, kv):
+        row = {"host_time": f"{time.time():.0f}"}
+        row.update(kv)
+        row.update({f"host_{k}": v for k, v in self.link.stats.items()})
+        if self.csv is None:
+            self.csv = csv.DictWriter(self.csv_file, fieldnames=list(row))
+            if self.csv_file.tell() == 0:
+                self.csv.writeheader()
+        self.csv.writerow({k: row.get(k, "") for k in self.csv.fieldnames})
+        self.rows.append({k: int(v) for k, v in kv.items() if v.isdigit()})
+        r = self.rows[-1]
+        print(f"up {r.get('up', 0) // 3600:3d}h{r.get('up', 0) // 60 % 60:02d}  "
+              f"heap {r.get('heap', 0):6d} min {r.get('heap_min', 0):6d} "
+              f"big {r.get('heap_big', 0):6d}  stale {r.get('stale_max', 0):5d} ms  "
+              f"p99 {r.get('lat_p99', 0):6d} us  dropped {r.get('dropped', 0)}")
+
+    def reader(self):
+        while not self.stop.is_set():
+            raw = self.ser.readline()
+            if not raw:
+                continue
+            line = raw.decode("ascii", "replace").rstrip()
+            self.raw.write(f"{time.time():.3f} {line}\n")
+            if m := self.SOAK_RE.search(line):
+                self.record(dict(kv.split("=", 1) for kv in m.group(1).split() if "=" in kv))
+            else:
+                self.note(line)
+
+    def tapper(self):
+        while not self.stop.wait(self.rng.uniform(0.5, 1.5) * self.args.tap_every):
+            name = self.rng.choice(list(TAP_TARGETS))
+            x, y = TAP_TARGETS[name]
+            hold = 80
+            if name in HOLD_TARGETS and self.rng.random() < 0.3:
+                hold = self.rng.randrange(700, 2500)
+            self.ser.write(f"T{x},{y},{hold}\n".encode())
+
+    def start(self):
+        threading.Thread(target=self.reader, daemon=True).start()
+        if self.args.tap_every > 0:
+            threading.Thread(target=self.tapper, daemon=True).start()
+
+
+# ---- Verdict ----
+
+
+def summarize(rows, events, args):
+    """Print the run summary; returns the number of failed checks"""
+    failures = 0
+
+    def check(ok, msg):
+        nonlocal failures
+        print(("  ok    " if ok else "  FAIL  ") + msg)
+        failures += 0 if ok else 1
+
+    print(f"\n{len(rows)} reports, {len(events)} console events")
+    if not rows:
+        check(False, "no [SOAK] reports received (esp32dev-soak firmware?)")
+        return failures
+
+    reboots = sum(1 for _, l in events if "rst:" in l or "=== BrewForge HMI" in l)
+    check(reboots == 0, f"{reboots} HMI resets")
+
+    live = [r for r in rows if r.get("link")]
+    stale = max((r.get("stale_max", 0) for r in live), default=0)
+    check(stale <= args.stale_ms, f"worst status age while linked {stale} ms (limit {args.stale_ms})")
+
+    heap_min = min(r.get("heap_min", 0) for r in rows)
+    big_min = min(r.get("heap_big", 0) for r in rows)
+    check(big_min >= args.min_block, f"smallest largest-free-block {big_min} B "
+                                     f"(limit {args.min_block}), heap low-water {heap_min} B")
+
+    # Fragmentation trend: largest block, first tenth of the run vs last tenth
+    n = max(1, len(rows) // 10)
+    head = sorted(r.get("heap_big", 0) for r in rows[:n])[n // 2]
+    tail = sorted(r.get("heap_big", 0) for r in rows[-n:])[n // 2]
+    check(head - tail <= args.frag_bytes,
+          f"largest free block {head} -> {tail} B over the run (limit -{args.frag_bytes})")
+
+    last = rows[-1]
+    lost = last.get("dropped", 0) + last.get("hwovr", 0)
+    check(lost <= args.max_lost, f"{lost} frames lost in the UART path "
+                                 f"({last.get('bad', 0)} rejected as bad, expected with fuzzing)")
+
+    p99 = max(r.get("lat_p99", 0) for r in rows)
+    check(p99 <= args.max_p99_us, f"worst rx -> pixel p99 {p99} us (limit {args.max_p99_us})")
+
+    stacks = [r.get(k, 0) for r in rows for k in ("stk_proto", "stk_loop") if k in r]
+    if stacks:
+        check(min(stacks) >= 512, f"lowest task stack headroom {min(stacks)} B")
+    return failures
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--pico-port", required=True, help="USB-UART adapter wired to the HMI's Serial2")
+    ap.add_argument("--console-port", required=True, help="the HMI's USB console")
+    ap.add_argument("--baud", type=int, default=115200, help="Serial2 baud, as PICO_BAUD in the firmware")
+    ap.add_argument("--hours", type=float, default=24.0)
+    ap.add_argument("--capture", help="recorded frames to replay instead of the simulated machine")
+    ap.add_argument("--fuzz", type=float, default=0.02, help="fraction of frames corrupted")
+    ap.add_argument("--delta", type=float, default=0.5, help="fraction of binary frames sent as deltas")
+    ap.add_argument("--burst-every", type=float, default=300, help="seconds between line-rate bursts (0: none)")
+    ap.add_argument("--burst-secs", type=float, default=10, help="length of each burst")
+    ap.add_argument("--tap-every", type=float, default=5, help="mean seconds between injected taps (0: none)")
+    ap.add_argument("--seed", type=int, default=None)
+    ap.add_argument("--out", default="soak_out", help="directory for soak.csv and console.log")
+    ap.add_argument("--stale-ms", type=int, default=1500)
+    ap.add_argument("--min-block", type=int, default=16384)
+    ap.add_argument("--frag-bytes", type=int, default=4096)
+    ap.add_argument("--max-lost", type=int, default=0)
+    ap.add_argument("--max-p99-us", type=int, default=100000)
+    args = ap.parse_args()
+
+    seed = args.seed if args.seed is not None else random.randrange(1 << 32)
+    rng = random.Random(seed)
+    out_dir = Path(args.out)
+    out_dir.mkdir(parents=True, exist_ok=True)
+    print(f"Soak run: {args.hours} h, seed {seed}, output in {out_dir}/")
+
+    link = PicoLink(args.pico_port, args.baud, args, rng)
+    console = Console(args.console_port, args, random.Random(seed + 1), link, out_dir)
+    link.start()
+    console.start()
+
+    try:
+        time.sleep(args.hours * 3600)
+    except KeyboardInterrupt:
+        print("\nInterrupted")
+    link.stop.set()
+    console.stop.set()
+    time.sleep(0.3)
+
+    failures = summarize(console.rows, console.events, args)
+    print(f"\nhost: {link.stats}")
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()